@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base64_decode_stream.hpp"
+#include "base64_encode_stream.hpp"
+#include "base64_kernel.hpp"
+#include "parallel_base64_encoder.hpp"
+#include "random_byte_stream.hpp"
+
+namespace {
+
+std::vector<uint8_t> RandomBytes(size_t n) {
+    std::mt19937 rng(42);
+    std::vector<uint8_t> res(n);
+    for (auto& b : res) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return res;
+}
+
+// Raw kernel throughput over an in-memory buffer; bytes_per_second is the input rate.
+void BM_Base64Kernel(benchmark::State& state) {
+    const auto kernel = static_cast<Base64Kernel>(state.range(0));
+    if (!Base64IsKernelSupported(kernel)) {
+        state.SkipWithError("kernel is not supported by this CPU");
+        return;
+    }
+    const auto in = RandomBytes(static_cast<size_t>(state.range(1)));
+    std::string out(in.size() / 3 * 4, '\0');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Base64EncodeTriplets(kernel, in.data(), in.size(), out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(Base64KernelName(kernel));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(in.size()));
+}
+
+// Whole stream over a RandomByteStream source, including the per-char TryRead() calls.
+void BM_Base64EncodeStream(benchmark::State& state) {
+    const auto kernel = static_cast<Base64Kernel>(state.range(0));
+    if (!Base64IsKernelSupported(kernel)) {
+        state.SkipWithError("kernel is not supported by this CPU");
+        return;
+    }
+    const size_t total = 1 << 22;
+    for (auto _ : state) {
+        Base64EncodeStream encoder(std::make_unique<RandomByteStream>(total, 1), 64 * 1024, kernel);
+        while (const std::optional<char> c = encoder.TryRead()) {
+            benchmark::DoNotOptimize(*c);
+        }
+    }
+    state.SetLabel(Base64KernelName(kernel));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(total));
+}
+
+// Decode kernel throughput; bytes_per_second is the rate of decoded output.
+void BM_Base64DecodeKernel(benchmark::State& state) {
+    const auto kernel = static_cast<Base64Kernel>(state.range(0));
+    if (!Base64IsKernelSupported(kernel)) {
+        state.SkipWithError("kernel is not supported by this CPU");
+        return;
+    }
+    const auto plain = RandomBytes(3 * 1024 * 1024);
+    std::string text(Base64EncodedLength(plain.size()), '\0');
+    Base64EncodeTriplets(Base64Kernel::Scalar, plain.data(), plain.size(), text.data());
+    std::vector<uint8_t> out(plain.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Base64DecodeQuartets(kernel, text.data(), text.size(), out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(Base64KernelName(kernel));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(plain.size()));
+}
+
+// Encode then decode through chained streams with 64 KiB buffers and bulk reads.
+void BM_Base64RoundTrip(benchmark::State& state) {
+    const auto kernel = static_cast<Base64Kernel>(state.range(0));
+    if (!Base64IsKernelSupported(kernel)) {
+        state.SkipWithError("kernel is not supported by this CPU");
+        return;
+    }
+    const size_t total = 1 << 24;
+    const size_t bufferSize = 64 * 1024;
+    std::vector<uint8_t> buffer(bufferSize);
+    for (auto _ : state) {
+        auto encoder = std::make_unique<Base64EncodeStream>(std::make_unique<RandomByteStream>(total, 1), bufferSize,
+                                                            kernel);
+        Base64DecodeStream decoder(std::move(encoder), bufferSize, Base64DecodeMode::Strict, kernel);
+        while (decoder.Read(std::span<uint8_t>(buffer)) != 0) {
+            benchmark::DoNotOptimize(buffer.data());
+        }
+    }
+    state.SetLabel(Base64KernelName(kernel));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(total));
+}
+
+// Chunked encoding of a 64 MiB buffer on a pool of state.range(0) threads.
+void BM_Base64Parallel(benchmark::State& state) {
+    const auto in = RandomBytes(64 * 1024 * 1024);
+    std::string out(Base64EncodedLength(in.size()), '\0');
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    ParallelBase64Encoder encoder(pool);
+    for (auto _ : state) {
+        encoder.Encode(in, std::span<char>(out));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(in.size()));
+}
+
+void KernelArgs(benchmark::internal::Benchmark* b) {
+    for (Base64Kernel kernel : {Base64Kernel::Scalar, Base64Kernel::Ssse3, Base64Kernel::Avx2, Base64Kernel::Avx512}) {
+        for (int64_t size : {3 * 1024, 3 * 1024 * 1024}) {
+            b->Args({static_cast<int64_t>(kernel), size});
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Base64Kernel)->Apply(KernelArgs);
+BENCHMARK(BM_Base64EncodeStream)->DenseRange(0, 3);
+BENCHMARK(BM_Base64Parallel)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK(BM_Base64DecodeKernel)->DenseRange(0, 3);
+BENCHMARK(BM_Base64RoundTrip)->DenseRange(0, 3);
@@ -0,0 +1,348 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "arena.hpp"
+#include "array_sequence.hpp"
+#include "concurrent_lazy_sequence.hpp"
+#include "dynamic_array.hpp"
+#include "lazy_sequence.hpp"
+#include "parallel_sequence.hpp"
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+// Grows an array one element at a time, the pattern ArraySequence used before it doubled its capacity.
+void BM_DynamicArrayResize(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        DynamicArray<int> a;
+        for (size_t i = 1; i <= n; ++i) {
+            a.Resize(i);
+        }
+        benchmark::DoNotOptimize(a.GetBegin());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+// Appends to a byte buffer in 4 KiB blocks, the pattern of SequenceWriteStream bulk writes.
+void BM_ArraySequenceAppendRange(benchmark::State& state) {
+    const auto total = static_cast<size_t>(state.range(0));
+    const std::vector<uint8_t> block(4096, 0x5a);
+    for (auto _ : state) {
+        ArraySequence<uint8_t> seq;
+        for (size_t done = 0; done < total; done += block.size()) {
+            seq.AppendRange(block);
+        }
+        benchmark::DoNotOptimize(seq.GetLength());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// Non-trivial elements are relocated by move on growth rather than copied.
+void BM_ArraySequenceAppendString(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    const std::string item(64, 'x');
+    for (auto _ : state) {
+        ArraySequence<std::string> seq;
+        for (int i = 0; i < n; ++i) {
+            seq.Append(item);
+        }
+        benchmark::DoNotOptimize(seq.GetLength());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ArraySequenceAppend(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        ArraySequence<int> seq;
+        for (int i = 0; i < n; ++i) {
+            seq.Append(i);
+        }
+        benchmark::DoNotOptimize(seq.GetLength());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Takes 1024 subsequences of state.range(0) items each from a 1 << 24 item sequence and sums their first items.
+void BM_ArraySequenceSlice(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<int64_t> data(1 << 24, 1);
+    const ArraySequence<int64_t> seq(data.begin(), data.end());
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < 1024; ++i) {
+            const size_t start = i * 4099 % (data.size() - n);
+            sum += seq.GetSubsequence(start, start + n - 1)->GetFirst();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+// Inserts in the middle, so every call shifts half of the sequence.
+void BM_ArraySequenceInsertAt(benchmark::State& state) {
+    const auto n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        ArraySequence<int> seq;
+        for (int i = 0; i < n; ++i) {
+            seq.InsertAt(i, seq.GetLength() / 2);
+        }
+        benchmark::DoNotOptimize(seq.GetLength());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+// Sums state.range(1) items. state.range(0) == 0 walks an ArraySequence through GetConstEnumerator, 1 with
+// range-for, 2 walks a LazySequence with range-for.
+void BM_SequenceIterate(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(1));
+    std::vector<int64_t> data(n, 3);
+    ArraySequence<int64_t> array(data.data(), static_cast<int>(n));
+    auto lazy = std::make_shared<LazySequence<int64_t>>(std::make_shared<ArraySequence<int64_t>>(array));
+    for (auto _ : state) {
+        int64_t sum = 0;
+        if (state.range(0) == 0) {
+            for (IConstEnumeratorPtr<int64_t> it = array.GetConstEnumerator(); !it->IsEnd(); it->MoveNext()) {
+                sum += it->ConstDereference();
+            }
+        } else if (state.range(0) == 1) {
+            for (int64_t x : array) {
+                sum += x;
+            }
+        } else {
+            for (int64_t x : *lazy) {
+                sum += x;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+LazySequencePtr<int64_t> Naturals() {
+    const int64_t first[] = {0};
+    return std::make_shared<LazySequence<int64_t>>(
+        [](SequencePtr<int64_t> last) {
+            return last->GetFirst() + 1;
+        },
+        std::make_shared<ArraySequence<int64_t>>(first, 1), 1);
+}
+
+// Materializes the first state.range(1) elements of a chain of state.range(0) Map/Where/Concat stages.
+void BM_LazySequenceChain(benchmark::State& state) {
+    const auto depth = state.range(0);
+    const auto n = static_cast<size_t>(state.range(1));
+    for (auto _ : state) {
+        LazySequencePtr<int64_t> seq = Naturals();
+        for (int64_t level = 0; level < depth; ++level) {
+            switch (level % 3) {
+                case 0:
+                    seq = seq->Map([](int64_t x) {
+                        return x + 1;
+                    });
+                    break;
+                case 1:
+                    seq = seq->Where([](int64_t x) {
+                        return x % 7 != 0;
+                    });
+                    break;
+                default:
+                    seq = seq->GetSubsequence(0, n)->Concat(Naturals());
+                    break;
+            }
+        }
+        benchmark::DoNotOptimize(seq->GetIndex(n - 1));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// A five-stage Map/Where chain over state.range(1) items, reduced to a sum. state.range(0) == 0 builds it from
+// LazySequence, 1 fuses it with pipeline.hpp.
+void BM_MapWhereChain(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(1));
+    std::vector<int64_t> data(n);
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = static_cast<int64_t>(i);
+    }
+    auto addOne = [](int64_t x) {
+        return x + 1;
+    };
+    auto notSeventh = [](int64_t x) {
+        return x % 7 != 0;
+    };
+    auto triple = [](int64_t x) {
+        return x * 3;
+    };
+    auto even = [](int64_t x) {
+        return (x & 1) == 0;
+    };
+    for (auto _ : state) {
+        int64_t sum = 0;
+        if (state.range(0) == 0) {
+            auto source = std::make_shared<ArraySequence<int64_t>>(data.data(), n);
+            auto seq = std::make_shared<LazySequence<int64_t>>(source)
+                           ->Map(addOne)
+                           ->Where(notSeventh)
+                           ->Map(triple)
+                           ->Where(even)
+                           ->Map(addOne);
+            sum = seq->Reduce(int64_t{0}, std::plus<>{});
+        } else {
+            sum = MakePipeline(std::span<const int64_t>(data))
+                      .Map(addOne)
+                      .Where(notSeventh)
+                      .Map(triple)
+                      .Where(even)
+                      .Map(addOne)
+                      .Reduce(int64_t{0}, std::plus<>{});
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// Random access into an already materialized chain, i.e. the memoized GetIndex path.
+void BM_LazySequenceGetIndexMemoized(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    auto doubled = Naturals()->Map([](int64_t x) {
+        return x * 2;
+    });
+    auto seq = doubled->Where([](int64_t x) {
+        return x % 3 != 0;
+    });
+    seq->GetIndex(n - 1);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(seq->GetIndex(i));
+        i = i + 1 == n ? 0 : i + 1;
+    }
+}
+
+// Reads one item of a subsequence that starts state.range(0) items into a random-access sequence.
+void BM_LazyRandomAccess(benchmark::State& state) {
+    const auto start = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        auto seq = LazySequence<int64_t>::FromFunction([](size_t i) {
+            return static_cast<int64_t>(i) * 3;
+        });
+        benchmark::DoNotOptimize(seq->GetSubsequence(start, start + 10)->GetIndex(5));
+    }
+}
+
+// Every thread reads the first 1 << 20 items of one shared sequence. state.range(0) == 0 guards a LazySequence
+// with a mutex, 1 reads a ConcurrentLazySequence; the first pass also materializes the items.
+void BM_SharedLazyGetIndex(benchmark::State& state) {
+    const size_t n = 1 << 20;
+    static std::mutex mutex;
+    static LazySequencePtr<int64_t> locked = Naturals();
+    static ConcurrentLazySequence<int64_t> concurrent(Naturals());
+    size_t i = static_cast<size_t>(state.thread_index()) * 4099 % n;
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            std::lock_guard lock(mutex);
+            benchmark::DoNotOptimize(locked->GetIndex(i));
+        } else {
+            benchmark::DoNotOptimize(concurrent.GetIndex(i));
+        }
+        i = i + 1 == n ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// ParallelReduce, ParallelMap and ParallelWhere (state.range(1) == 0, 1, 2) over 100M computed items with
+// state.range(0) pool threads besides the caller.
+void BM_ParallelLazy(benchmark::State& state) {
+    const size_t n = 100000000;
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto seq = LazySequence<int32_t>::FromFunction([](size_t i) {
+                   return static_cast<int32_t>(i * 2654435761u);
+               })
+                   ->GetSubsequence(0, n - 1);
+    for (auto _ : state) {
+        switch (state.range(1)) {
+            case 0:
+                benchmark::DoNotOptimize(ParallelReduce(pool, seq, int64_t{0}, std::plus<>{}));
+                break;
+            case 1:
+                benchmark::DoNotOptimize(ParallelMap(pool, seq, [](int32_t x) {
+                    return x / 3;
+                }));
+                break;
+            default:
+                benchmark::DoNotOptimize(ParallelWhere(pool, seq, [](int32_t x) {
+                    return x % 3 == 0;
+                }));
+                break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+
+// Generates state.range(0) items of a two-term recurrence, one generator call per item.
+void BM_LazyRecurrence(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        auto start = std::make_shared<ArraySequence<int64_t>>();
+        start->Append(1);
+        start->Append(1);
+        auto fib = std::make_shared<LazySequence<int64_t>>(
+            [](SequencePtr<int64_t> last2) {
+                return (last2->Get(0) + last2->Get(1)) & 0xffffffff;
+            },
+            start, 2);
+        benchmark::DoNotOptimize(fib->GetIndex(n - 1));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The same recurrence with the memo's allocations routed by state.range(0): 0 = global heap,
+// 1 = SizeClassPool, 2 = MonotonicArena. Runs on one thread, since ScopedDefaultResource is process-wide.
+void BM_LazyRecurrenceAllocator(benchmark::State& state) {
+    const size_t n = 1 << 16;
+    for (auto _ : state) {
+        SizeClassPool pool;
+        MonotonicArena arena;
+        std::pmr::memory_resource* resources[] = {std::pmr::new_delete_resource(), &pool, &arena};
+        ScopedDefaultResource scope(resources[state.range(0)]);
+        auto start = std::make_shared<ArraySequence<int64_t>>();
+        start->Append(1);
+        start->Append(1);
+        auto fib = std::make_shared<LazySequence<int64_t>>(
+            [](SequencePtr<int64_t> last2) {
+                return last2->Get(0) + last2->Get(1);
+            },
+            start, 2);
+        benchmark::DoNotOptimize(fib->GetIndex(n - 1));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+
+}  // namespace
+
+BENCHMARK(BM_DynamicArrayResize)->RangeMultiplier(4)->Range(256, 16384)->Complexity();
+BENCHMARK(BM_ArraySequenceAppend)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_ArraySequenceAppendRange)->Arg(1 << 26);
+BENCHMARK(BM_ArraySequenceAppendString)->Arg(1 << 16);
+BENCHMARK(BM_ArraySequenceSlice)->Arg(16)->Arg(1 << 20);
+BENCHMARK(BM_ArraySequenceInsertAt)->RangeMultiplier(4)->Range(256, 16384)->Complexity();
+BENCHMARK(BM_SequenceIterate)->ArgsProduct({{0, 1, 2}, {1 << 16}});
+BENCHMARK(BM_LazySequenceChain)->ArgsProduct({{1, 3, 9, 27}, {1 << 10, 1 << 16}});
+BENCHMARK(BM_MapWhereChain)->ArgsProduct({{0, 1}, {1 << 16}});
+BENCHMARK(BM_LazySequenceGetIndexMemoized)->Arg(1 << 16);
+BENCHMARK(BM_LazyRandomAccess)->Arg(1 << 10)->Arg(1000000000);
+BENCHMARK(BM_ParallelLazy)
+    ->ArgsProduct({{1, 2, 4, 8}, {0, 1, 2}})
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SharedLazyGetIndex)->DenseRange(0, 1)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_LazyRecurrenceAllocator)->DenseRange(0, 2);
+BENCHMARK(BM_LazyRecurrence)->Arg(1 << 20)->Arg(100000000)->Iterations(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "base64_encode_stream.hpp"
+#include "random_byte_stream.hpp"
+#include "read_stream.hpp"
+#include "write_stream.hpp"
+
+namespace {
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Encoder throughput over a random source as a function of the encoder's input buffer size.
+void BM_Base64EncodeStreamBufferSize(benchmark::State& state) {
+    const auto bufferSize = static_cast<size_t>(state.range(0));
+    const size_t total = 1 << 22;
+    std::vector<char> out(64 * 1024);
+    for (auto _ : state) {
+        Base64EncodeStream encoder(std::make_unique<RandomByteStream>(total, 1), bufferSize);
+        while (encoder.Read(std::span<char>(out)) != 0) {
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(total));
+}
+
+// Copies a file through FileReadStream and FileWriteStream in blocks of state.range(0) elements;
+// a block of 1 goes through the per-element Read()/Write() calls.
+void BM_FileCopyPipeline(benchmark::State& state) {
+    const auto block = static_cast<size_t>(state.range(0));
+    const size_t total = 1 << 22;
+    const std::string in = TempPath("lab1_bench_in.bin");
+    const std::string out = TempPath("lab1_bench_out.bin");
+    {
+        FileWriteStream<uint8_t, RawSerialize<uint8_t>> writer(in, RawSerialize<uint8_t>{});
+        RandomByteStream src(total, 1);
+        std::vector<uint8_t> buffer(total);
+        src.Read(std::span<uint8_t>(buffer));
+        writer.Write(std::span<const uint8_t>(buffer));
+    }
+
+    std::vector<uint8_t> buffer(block);
+    for (auto _ : state) {
+        FileReadStream<uint8_t, RawParse<uint8_t>> reader(in, RawParse<uint8_t>{});
+        FileWriteStream<uint8_t, RawSerialize<uint8_t>> writer(out, RawSerialize<uint8_t>{});
+        if (block == 1) {
+            while (!reader.IsEndOfStream()) {
+                writer.Write(reader.Read());
+            }
+        } else {
+            while (size_t n = reader.Read(std::span<uint8_t>(buffer))) {
+                writer.Write(std::span<const uint8_t>(buffer.data(), n));
+            }
+        }
+        writer.Flush();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(total));
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+}
+
+}  // namespace
+
+BENCHMARK(BM_Base64EncodeStreamBufferSize)->RangeMultiplier(8)->Range(3, 3 << 18);
+BENCHMARK(BM_FileCopyPipeline)->Arg(1)->Arg(4096)->Arg(64 * 1024);
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+// Memory resources for std::pmr::polymorphic_allocator, e.g. DynamicArray<T, std::pmr::polymorphic_allocator<T>>.
+// Neither of them is thread-safe, and memory handed out must not outlive the resource.
+
+// Bump allocator: deallocation is a no-op and everything is returned to upstream at once by Release() or the
+// destructor. Chunks double in size, so a workload of n bytes costs O(log n) upstream calls.
+class MonotonicArena : public std::pmr::memory_resource {
+public:
+    explicit MonotonicArena(size_t initialChunkBytes = 64 * 1024,
+                            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream), initialChunkBytes_(std::max<size_t>(initialChunkBytes, 64)),
+          nextChunkBytes_(initialChunkBytes_) {
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() override {
+        Release();
+    }
+
+    void Release() {
+        for (const Chunk& chunk : chunks_) {
+            upstream_->deallocate(chunk.data, chunk.size, alignof(std::max_align_t));
+        }
+        chunks_.clear();
+        cur_ = nullptr;
+        end_ = nullptr;
+        nextChunkBytes_ = initialChunkBytes_;
+        allocatedBytes_ = 0;
+    }
+
+    // Bytes requested since the last Release().
+    size_t GetAllocatedBytes() const {
+        return allocatedBytes_;
+    }
+
+    size_t GetChunkCount() const {
+        return chunks_.size();
+    }
+
+private:
+    struct Chunk {
+        std::byte* data;
+        size_t size;
+    };
+
+    std::pmr::memory_resource* const upstream_;
+    const size_t initialChunkBytes_;
+    size_t nextChunkBytes_;
+    std::vector<Chunk> chunks_;
+    std::byte* cur_ = nullptr;
+    std::byte* end_ = nullptr;
+    size_t allocatedBytes_ = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        std::byte* p = AlignUp(cur_, alignment);
+        if (cur_ == nullptr || p + bytes > end_) {
+            const size_t size = std::max(nextChunkBytes_, bytes + alignment);
+            std::byte* data = static_cast<std::byte*>(upstream_->allocate(size, alignof(std::max_align_t)));
+            chunks_.push_back({data, size});
+            nextChunkBytes_ = size * 2;
+            end_ = data + size;
+            p = AlignUp(data, alignment);
+        }
+        allocatedBytes_ += bytes;
+        cur_ = p + bytes;
+        return p;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    static std::byte* AlignUp(std::byte* p, size_t alignment) {
+        const auto addr = reinterpret_cast<std::uintptr_t>(p);
+        return p + ((alignment - addr % alignment) % alignment);
+    }
+};
+
+// Segregated free lists for blocks of 8 to 1024 bytes, rounded up to a power of two. Freed blocks go back to
+// their list and are reused, so steady-state churn of small objects (shared_ptr control blocks, short
+// subsequences) never reaches upstream. Larger or over-aligned requests are forwarded to upstream.
+class SizeClassPool : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kMinBlockBytes = 8;
+    static constexpr size_t kMaxBlockBytes = 1024;
+
+    explicit SizeClassPool(size_t slabBytes = 64 * 1024,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream), slabBytes_(std::max(slabBytes, kMaxBlockBytes)) {
+    }
+
+    SizeClassPool(const SizeClassPool&) = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    ~SizeClassPool() override {
+        Release();
+    }
+
+    // Returns all slabs to upstream. Blocks above kMaxBlockBytes are owned by their users and must be
+    // deallocated by them.
+    void Release() {
+        for (std::byte* slab : slabs_) {
+            upstream_->deallocate(slab, slabBytes_, alignof(std::max_align_t));
+        }
+        slabs_.clear();
+        freeLists_.fill(nullptr);
+    }
+
+    size_t GetSlabCount() const {
+        return slabs_.size();
+    }
+
+private:
+    static constexpr size_t kClassCount = std::countr_zero(kMaxBlockBytes) - std::countr_zero(kMinBlockBytes) + 1;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::pmr::memory_resource* const upstream_;
+    const size_t slabBytes_;
+    std::array<FreeBlock*, kClassCount> freeLists_{};
+    std::vector<std::byte*> slabs_;
+
+    static size_t ClassIndex(size_t bytes) {
+        return std::countr_zero(std::bit_ceil(std::max(bytes, kMinBlockBytes))) - std::countr_zero(kMinBlockBytes);
+    }
+
+    static bool IsPooled(size_t bytes, size_t alignment) {
+        return bytes <= kMaxBlockBytes && alignment <= alignof(std::max_align_t);
+    }
+
+    // Cuts a new slab into blocks of the class; blocks are naturally aligned within the slab.
+    void Refill(size_t index) {
+        const size_t blockBytes = kMinBlockBytes << index;
+        auto* slab = static_cast<std::byte*>(upstream_->allocate(slabBytes_, alignof(std::max_align_t)));
+        slabs_.push_back(slab);
+        FreeBlock* head = freeLists_[index];
+        for (size_t off = slabBytes_ / blockBytes * blockBytes; off != 0; off -= blockBytes) {
+            head = new (slab + off - blockBytes) FreeBlock{head};
+        }
+        freeLists_[index] = head;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (!IsPooled(bytes, alignment)) {
+            return upstream_->allocate(bytes, alignment);
+        }
+        const size_t index = ClassIndex(std::max(bytes, alignment));
+        if (freeLists_[index] == nullptr) {
+            Refill(index);
+        }
+        FreeBlock* block = freeLists_[index];
+        freeLists_[index] = block->next;
+        return block;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        if (!IsPooled(bytes, alignment)) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        const size_t index = ClassIndex(std::max(bytes, alignment));
+        freeLists_[index] = new (p) FreeBlock{freeLists_[index]};
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Like std::pmr::polymorphic_allocator, but a default-constructed allocator with the default resource left at
+// new_delete_resource() goes straight to std::allocator, so code that never installs an arena pays no
+// virtual call per allocation.
+template <typename T>
+class ResourceAllocator {
+    template <typename>
+    friend class ResourceAllocator;
+
+public:
+    using value_type = T;
+
+    ResourceAllocator() noexcept : ResourceAllocator(std::pmr::get_default_resource()) {
+    }
+
+    ResourceAllocator(std::pmr::memory_resource* resource) noexcept
+        : resource_(resource == std::pmr::new_delete_resource() ? nullptr : resource) {
+    }
+
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U>& other) noexcept : resource_(other.resource_) {
+    }
+
+    T* allocate(size_t n) {
+        if (resource_ == nullptr) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (resource_ == nullptr) {
+            std::allocator<T>().deallocate(p, n);
+        } else {
+            resource_->deallocate(p, n * sizeof(T), alignof(T));
+        }
+    }
+
+    // Copies of a container get the default resource, as with polymorphic_allocator.
+    ResourceAllocator select_on_container_copy_construction() const {
+        return ResourceAllocator();
+    }
+
+    std::pmr::memory_resource* GetResource() const {
+        return resource_ == nullptr ? std::pmr::new_delete_resource() : resource_;
+    }
+
+    template <typename U>
+    bool operator==(const ResourceAllocator<U>& other) const noexcept {
+        return resource_ == other.resource_ || (resource_ != nullptr && other.resource_ != nullptr &&
+                                                resource_->is_equal(*other.resource_));
+    }
+
+private:
+    std::pmr::memory_resource* resource_;
+};
+
+// Installs resource as std::pmr::get_default_resource() until destroyed, then restores the previous one.
+// LazySequence takes its memo storage from the default resource, so this routes a whole lazy pipeline into an
+// arena or pool. The default resource is process-wide, not per thread: while this is alive, every thread that
+// constructs a LazySequence or a default ResourceAllocator allocates from resource. MonotonicArena and
+// SizeClassPool are not thread-safe, so no other thread may do so meanwhile, e.g. no ThreadPool may be running
+// lazy or parallel sequence work.
+class ScopedDefaultResource {
+public:
+    explicit ScopedDefaultResource(std::pmr::memory_resource* resource)
+        : previous_(std::pmr::set_default_resource(resource)) {
+    }
+
+    ScopedDefaultResource(const ScopedDefaultResource&) = delete;
+    ScopedDefaultResource& operator=(const ScopedDefaultResource&) = delete;
+
+    ~ScopedDefaultResource() {
+        std::pmr::set_default_resource(previous_);
+    }
+
+private:
+    std::pmr::memory_resource* const previous_;
+};
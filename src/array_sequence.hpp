@@ -1,11 +1,34 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
+#include "checked.hpp"
 #include "dynamic_array.hpp"
 #include "ienum.hpp"
 #include "sequence.hpp"
 
+// ThreadSanitizer does not model the fence ArraySequence uses to take over a buffer, so under it the hand-over is
+// annotated instead.
+#if defined(__SANITIZE_THREAD__)
+#define LAB1_TSAN
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define LAB1_TSAN
+#endif
+#endif
+
+#ifdef LAB1_TSAN
+#include <sanitizer/tsan_interface.h>
+#endif
+
 template <typename T>
 class ArraySequenceIterator : public IEnumerator<T> {
 public:
@@ -64,75 +87,143 @@ private:
     size_t index_ = 0;
 };
 
-template <typename T>
+// Items live in a reference-counted buffer. Copies, subsequences, GetFirst(count) and GetLast(count) are O(1)
+// views of their source's buffer. The first mutation of a sequence whose buffer is shared, or that views only
+// part of it, copies its own items into a fresh buffer (copy-on-write). References returned by Get stay valid
+// until this sequence is mutated. A view keeps the whole buffer of its source alive.
+//
+// Buffers and derived sequences (and their shared_ptr control blocks) use the allocator of their source, so an
+// ArraySequence over an arena keeps all of them in that arena.
+template <typename T, typename Allocator = std::allocator<T>>
 class ArraySequence : public Sequence<T>, public IEnumerable<T> {
+    using Buffer = DynamicArray<T, Allocator>;
+    using BufferPtr = std::shared_ptr<Buffer>;
+
+    struct ViewTag {};
+
 public:
-    ArraySequence(const T* items, int count) {
+    ArraySequence(const T* items, int count, const Allocator& alloc = Allocator())
+        : alloc_(alloc), buffer_(std::allocate_shared<Buffer>(alloc, items, count, alloc)), window_(kWhole) {
         if (count == 0) {
-            capacity_ = 1;
-            size_ = 0;
-            data_ = DynamicArray<T>(capacity_);
-        } else {
-            capacity_ = count;
-            size_ = count;
-            data_ = DynamicArray<T>(items, count);
+            buffer_->Reserve(1);
         }
     }
 
-    ArraySequence(DynamicArray<T> a) : capacity_(a.GetSize()), size_(a.GetSize()), data_(std::move(a)) {
+    ArraySequence(DynamicArray<T, Allocator> a)
+        : alloc_(a.GetAllocator()), buffer_(std::allocate_shared<Buffer>(alloc_, std::move(a))), window_(kWhole) {
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    ArraySequence(It first, S last, const Allocator& alloc = Allocator()) : alloc_(alloc) {
+        AppendRange(first, last);
     }
 
-    ArraySequence(const Sequence<T>& a) : capacity_(a.GetCapacity()), size_(0), data_(capacity_) {
+    // Shares the buffer of another ArraySequence with an equal allocator.
+    ArraySequence(const Sequence<T>& a, const Allocator& alloc = Allocator()) : alloc_(alloc) {
+        if (const auto* array = dynamic_cast<const ArraySequence*>(&a)) {
+            if (array->alloc_ == alloc_) {
+                buffer_ = array->buffer_;
+                offset_ = array->offset_;
+                window_ = array->window_;
+            } else {
+                AppendRange(std::span<const T>(array->begin(), array->end()));
+            }
+            return;
+        }
+        Reserve(a.GetCapacity());
         for (IConstEnumeratorPtr<T> it = a.GetConstEnumerator(); !it->IsEnd(); it->MoveNext()) {
             Append(it->ConstDereference());
         }
     }
 
-    ArraySequence(SequencePtr<T> a) : ArraySequence(*a) {
+    ArraySequence(SequencePtr<T> a, const Allocator& alloc = Allocator()) : ArraySequence(*a, alloc) {
+    }
+
+    explicit ArraySequence(const Allocator& alloc) : alloc_(alloc) {
+        Own();
+    }
+
+    ArraySequence() : ArraySequence(Allocator()) {
+    }
+
+    // A view of count items of buffer from offset on; used by GetSubsequence through allocate_shared.
+    ArraySequence(ViewTag, BufferPtr buffer, size_t offset, size_t count, const Allocator& alloc)
+        : alloc_(alloc), buffer_(std::move(buffer)), offset_(offset), window_(count) {
+    }
+
+    ArraySequence(const ArraySequence&) = default;
+
+    ArraySequence(ArraySequence&& other) noexcept
+        : alloc_(other.alloc_),
+          buffer_(std::move(other.buffer_)),
+          offset_(std::exchange(other.offset_, 0)),
+          window_(std::exchange(other.window_, 0)) {
+    }
+
+    ~ArraySequence() override {
+        ReleaseBuffer();
     }
 
-    ArraySequence() : capacity_(1), size_(0), data_(capacity_) {
+    // The allocator is kept, like DynamicArray keeps it; a buffer of another allocator is shared until the
+    // first mutation copies it.
+    ArraySequence& operator=(const ArraySequence& other) {
+        ReleaseBuffer();
+        buffer_ = other.buffer_;
+        offset_ = other.offset_;
+        window_ = other.window_;
+        return *this;
+    }
+
+    ArraySequence& operator=(ArraySequence&& other) noexcept {
+        if (this != &other) {
+            ReleaseBuffer();
+            buffer_ = std::move(other.buffer_);
+            offset_ = std::exchange(other.offset_, 0);
+            window_ = std::exchange(other.window_, 0);
+        }
+        return *this;
     }
 
     const T& GetFirst() override {
-        if (size_ == 0) {
+        if (GetLength() == 0) {
             throw std::out_of_range("Sequence is empty");
         }
-        return data_.Get(0);
+        return Data()[0];
     }
 
     const T& GetLast() override {
-        if (size_ == 0) {
+        if (GetLength() == 0) {
             throw std::out_of_range("Sequence is empty");
         }
-        return data_.Get(size_ - 1);
+        return Data()[GetLength() - 1];
     }
 
     const T& Get(size_t index) override {
-        if (index >= size_) {
-            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        if (index >= GetLength()) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " +
+                                    std::to_string(GetLength()));
         }
-        return data_.Get(index);
+        return Data()[index];
     }
 
     SequencePtr<T> GetSubsequence(size_t startIndex, size_t endIndex) const override {
-        if (startIndex >= size_ || endIndex >= size_) {
+        const size_t length = GetLength();
+        if (startIndex >= length || endIndex >= length) {
             throw std::out_of_range("Index is out of range: " + std::to_string(startIndex) + " " +
-                                    std::to_string(endIndex) + " " + std::to_string(size_));
+                                    std::to_string(endIndex) + " " + std::to_string(length));
         }
         if (startIndex > endIndex) {
             throw std::out_of_range("startIndex is greater than endIndex");
         }
-        const T* start = data_.GetConstBegin() + startIndex;
-        size_t sz = endIndex - startIndex + 1;
-        return std::make_shared<ArraySequence<T>>(start, sz);
+        return std::allocate_shared<ArraySequence>(alloc_, ViewTag{}, buffer_, offset_ + startIndex,
+                                                   endIndex - startIndex + 1, alloc_);
     }
 
     SequencePtr<T> GetFirst(size_t count) const override {
         if (count == 0) {
-            return std::make_shared<ArraySequence>();
+            return std::allocate_shared<ArraySequence>(alloc_, alloc_);
         }
-        if (count > size_) {
+        if (count > GetLength()) {
             throw std::out_of_range("Requested elements count is greater than size");
         }
         return GetSubsequence(0, count - 1);
@@ -140,70 +231,253 @@ public:
 
     SequencePtr<T> GetLast(size_t count) const override {
         if (count == 0) {
-            return std::make_shared<ArraySequence>();
+            return std::allocate_shared<ArraySequence>(alloc_, alloc_);
         }
-        if (count > size_) {
+        if (count > GetLength()) {
             throw std::out_of_range("Requested elements count is greater than size");
         }
-        return GetSubsequence(size_ - count, size_ - 1);
+        return GetSubsequence(GetLength() - count, GetLength() - 1);
     }
 
     size_t GetLength() const override {
-        return size_;
+        return window_ == kWhole ? buffer_->GetSize() : window_;
     }
 
+    // A view has no room of its own to grow into.
     size_t GetCapacity() const override {
-        return capacity_;
+        return IsOwned() ? buffer_->GetCapacity() : GetLength();
+    }
+
+    bool IsShared() const {
+        return buffer_.use_count() > 1;
+    }
+
+    const T* GetConstBegin() const {
+        return Data();
+    }
+
+    // Unchecked unlike Get, except in LAB1_CHECKED builds. The non-const accessors copy a shared buffer first, so
+    // hot loops should take data() once.
+    T& operator[](size_t index) {
+        CheckIndex(index, GetLength());
+        return data()[index];
+    }
+
+    const T& operator[](size_t index) const {
+        CheckIndex(index, GetLength());
+        return Data()[index];
+    }
+
+    T* data() {
+        Own();
+        return buffer_->GetBegin();
+    }
+
+    const T* data() const {
+        return Data();
+    }
+
+    // Plain pointers, so the sequence is a std::ranges::contiguous_range and range-for, standard algorithms and
+    // std::span see the items directly, without an enumerator. The non-const pair copies a shared buffer first.
+    T* begin() {
+        return data();
+    }
+
+    T* end() {
+        return data() + GetLength();
+    }
+
+    const T* begin() const {
+        return Data();
+    }
+
+    const T* end() const {
+        return Data() + GetLength();
+    }
+
+    size_t CopyTo(size_t startIndex, std::span<T> out) override {
+        const size_t length = GetLength();
+        if (startIndex >= length) {
+            return 0;
+        }
+        const size_t n = std::min(out.size(), length - startIndex);
+        std::copy_n(Data() + startIndex, n, out.data());
+        return n;
+    }
+
+    void Reserve(size_t capacity) override {
+        Own(capacity);
+        buffer_->Reserve(capacity);
     }
 
     void Append(const T& item) override {
-        PushBack(item);
+        // The common case, kept free of Own's shared_ptr result.
+        if (IsOwned()) [[likely]] {
+            buffer_->PushBack(item);
+            return;
+        }
+        const BufferPtr previous = Own(GetLength() + 1);
+        buffer_->PushBack(item);
+    }
+
+    void AppendRange(std::span<const T> items) override {
+        const BufferPtr previous = Own(GetLength() + items.size());
+        buffer_->AppendRange(items.data(), items.size());
+    }
+
+    // Contiguous ranges of T are copied in one AppendRange; other ranges reserve first when their size is known.
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    void AppendRange(It first, S last) {
+        if constexpr (kIsContiguousOf<It, S>) {
+            AppendRange(std::span<const T>(std::to_address(first), static_cast<size_t>(last - first)));
+        } else {
+            size_t capacity = GetLength();
+            if constexpr (std::sized_sentinel_for<S, It>) {
+                capacity += static_cast<size_t>(last - first);
+            }
+            const BufferPtr previous = Own(capacity);
+            buffer_->Reserve(capacity);
+            for (; first != last; ++first) {
+                buffer_->EmplaceBack(*first);
+            }
+        }
+    }
+
+    // Shifts the items from index on once, by the whole range, instead of once per item.
+    void InsertRange(std::span<const T> items, size_t index) {
+        CheckInsertIndex(index);
+        const BufferPtr previous = Own(GetLength() + items.size());
+        buffer_->InsertRange(index, items.data(), items.size());
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    void InsertRange(It first, S last, size_t index) {
+        if constexpr (kIsContiguousOf<It, S>) {
+            InsertRange(std::span<const T>(std::to_address(first), static_cast<size_t>(last - first)), index);
+        } else {
+            CheckInsertIndex(index);
+            const ArraySequence items(first, last, alloc_);
+            InsertRange(std::span<const T>(items.begin(), items.end()), index);
+        }
     }
 
     void Prepend(const T& item) override {
-        Insert(item, 0);
+        InsertAt(item, 0);
     }
 
     void InsertAt(const T& item, size_t index) override {
-        Insert(item, index);
+        CheckInsertIndex(index);
+        const BufferPtr previous = Own(GetLength() + 1);
+        buffer_->Insert(index, item);
+    }
+
+    // Removes the items from startIndex through endIndex inclusive. A view that drops items at either end
+    // just narrows, without copying the rest.
+    void RemoveRange(size_t startIndex, size_t endIndex) {
+        const size_t length = GetLength();
+        if (startIndex > endIndex) {
+            throw std::out_of_range("startIndex is greater than endIndex");
+        }
+        if (endIndex >= length) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(endIndex) + " " +
+                                    std::to_string(length));
+        }
+        const size_t count = endIndex - startIndex + 1;
+        if (!IsOwned() && (startIndex == 0 || endIndex + 1 == length)) {
+            if (startIndex == 0) {
+                offset_ += count;
+            }
+            window_ = length - count;
+            return;
+        }
+        Own();
+        buffer_->Erase(startIndex, count);
     }
 
+    // Keeps the capacity of an owned buffer; a view lets go of its source's.
     void Clear() override {
-        size_ = 0;
+        if (IsOwned()) {
+            buffer_->Clear();
+            return;
+        }
+        ReleaseBuffer();
+        buffer_ = nullptr;
+        offset_ = 0;
+        window_ = 0;
     }
 
     IEnumeratorPtr<T> GetEnumerator() override {
-        return std::make_shared<ArraySequenceIterator<T>>(data_.GetBegin(), size_);
+        T* first = begin();
+        return std::make_shared<ArraySequenceIterator<T>>(first, GetLength());
     }
 
     IConstEnumeratorPtr<T> GetConstEnumerator() const override {
-        return std::make_shared<ArraySequenceConstIterator<T>>(data_.GetConstBegin(), size_);
+        return std::make_shared<ArraySequenceConstIterator<T>>(Data(), GetLength());
     }
 
 private:
-    size_t capacity_;
-    size_t size_;
-    DynamicArray<T> data_;
+    // window_ of a sequence that is all of its buffer, from offset_ 0 to the buffer's end.
+    static constexpr size_t kWhole = static_cast<size_t>(-1);
+
+    template <typename It, typename S>
+    static constexpr bool kIsContiguousOf =
+        std::contiguous_iterator<It> && std::sized_sentinel_for<S, It> && std::same_as<std::iter_value_t<It>, T>;
+
+    [[no_unique_address]] Allocator alloc_;
+    // Null only while empty, e.g. after a move or after clearing a view.
+    BufferPtr buffer_;
+    size_t offset_ = 0;
+    // The number of items viewed from offset_ on, or kWhole.
+    size_t window_ = 0;
+
+    const T* Data() const {
+        return buffer_ ? buffer_->GetConstBegin() + offset_ : nullptr;
+    }
 
-    void PushBack(const T& item) {
-        if (size_ == capacity_) {
-            capacity_ *= 2;
-            data_.Resize(capacity_);
+    // Whether buffer_ can be written in place: it holds exactly this sequence's items and no one else uses it.
+    bool IsOwned() const {
+        if (window_ != kWhole || buffer_.use_count() != 1) {
+            return false;
         }
-        data_.Set(size_, item);
-        ++size_;
+        // Pairs with the release in the last other owner's decrement, so its reads precede our writes.
+#ifdef LAB1_TSAN
+        __tsan_acquire(buffer_.get());
+#else
+        std::atomic_thread_fence(std::memory_order_acquire);
+#endif
+        return true;
     }
 
-    void Insert(const T& item, int index) {
-        if (size_ == capacity_) {
-            data_.Resize(capacity_ * 2);
-            capacity_ *= 2;
+    // Called before this sequence lets go of buffer_. Only ThreadSanitizer needs to see it: the decrement of the
+    // use count is the release that IsOwned pairs with.
+    void ReleaseBuffer() const {
+#ifdef LAB1_TSAN
+        if (buffer_) {
+            __tsan_release(buffer_.get());
         }
-        for (int i = size_ - 1; i >= index; --i) {
-            T cur = data_.Get(i);
-            data_.Set(i + 1, cur);
+#endif
+    }
+
+    // Makes buffer_ owned, copying the items into a fresh buffer of at least capacity slots if it is not. Returns
+    // the previous buffer, which the caller keeps alive while its arguments may still point into it.
+    BufferPtr Own(size_t capacity = 0) {
+        if (IsOwned()) {
+            return nullptr;
+        }
+        const size_t length = GetLength();
+        auto buffer = std::allocate_shared<Buffer>(alloc_, alloc_);
+        buffer->Reserve(std::max({capacity, length, size_t{1}}));
+        buffer->AppendRange(Data(), length);
+        offset_ = 0;
+        window_ = kWhole;
+        ReleaseBuffer();
+        return std::exchange(buffer_, std::move(buffer));
+    }
+
+    void CheckInsertIndex(size_t index) const {
+        if (index > GetLength()) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " +
+                                    std::to_string(GetLength()));
         }
-        data_.Set(index, item);
-        ++size_;
     }
 };
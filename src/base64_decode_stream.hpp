@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "base64_kernel.hpp"
+#include "base64_variant.hpp"
+#include "fwd.hpp"
+#include "stream.hpp"
+
+enum class Base64DecodeMode {
+    // Alphabet chars only; the final quartet must be padded with '=' unless the variant omits padding, and the
+    // unused low bits of its last char must be zero. Line breaks are always skipped for variants that wrap lines.
+    Strict,
+    // Whitespace is skipped and the final padding may be missing.
+    Lenient,
+};
+
+template <typename Variant = Base64Standard>
+class BasicBase64DecodeStream : public ReadOnlyStream<uint8_t> {
+public:
+    using ReadOnlyStream<uint8_t>::Read;
+
+    explicit BasicBase64DecodeStream(std::unique_ptr<ReadOnlyStream<char>> src, size_t bufferSizeBytes = 4,
+                                     Base64DecodeMode mode = Base64DecodeMode::Strict,
+                                     Base64Kernel kernel = Base64BestKernel())
+        : src_(std::move(src)), bufferSize_(std::max<size_t>(1, bufferSizeBytes)), mode_(mode), kernel_(kernel) {
+    }
+
+    bool IsEndOfStream() const override {
+        return inputDone_ && outPos_ >= out_.size();
+    }
+
+    uint8_t Read() override {
+        const std::optional<uint8_t> c = TryRead();
+        if (!c) {
+            throw std::runtime_error("End of stream");
+        }
+        return *c;
+    }
+
+    std::optional<uint8_t> TryRead() override {
+        if (outPos_ >= out_.size()) {
+            if (inputDone_) {
+                return std::nullopt;
+            }
+            ProduceOutput();
+            if (out_.empty()) {
+                return std::nullopt;
+            }
+        }
+        count_++;
+        return out_[outPos_++];
+    }
+
+    size_t Read(std::span<uint8_t> out) override {
+        size_t n = 0;
+        while (n < out.size()) {
+            if (outPos_ >= out_.size()) {
+                if (inputDone_) {
+                    break;
+                }
+                ProduceOutput();
+                if (out_.empty()) {
+                    break;
+                }
+            }
+            const size_t chunk = std::min(out.size() - n, out_.size() - outPos_);
+            std::copy_n(out_.data() + outPos_, chunk, out.data() + n);
+            outPos_ += chunk;
+            n += chunk;
+        }
+        count_ += n;
+        return n;
+    }
+
+    size_t GetPosition() const override {
+        return count_;
+    }
+
+    bool IsCanSeek() const override {
+        return false;
+    }
+
+    size_t Seek(size_t index) override {
+        throw std::logic_error("Cannot seek in base64 decode stream");
+    }
+
+    bool IsCanGoBack() const override {
+        return false;
+    }
+
+private:
+    std::unique_ptr<ReadOnlyStream<char>> src_;
+
+    const size_t bufferSize_;
+    const Base64DecodeMode mode_;
+    const Base64Kernel kernel_;
+
+    std::vector<uint8_t> out_;
+    size_t outPos_ = 0;
+
+    // Chars of a quartet split between two refills.
+    std::array<char, 3> carry_{};
+    size_t carryLen_ = 0;
+
+    std::vector<char> in_;
+    // The block being decoded: either in_ or a zero-copy view of the source.
+    std::span<const char> input_;
+
+    size_t count_ = 0;
+    bool inputDone_ = false;
+    bool padded_ = false;
+
+    static bool IsSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    bool IsSkippingSpace() const {
+        return mode_ == Base64DecodeMode::Lenient || Variant::kLineLength != 0;
+    }
+
+    bool IsPaddingRequired() const {
+        return mode_ == Base64DecodeMode::Strict && Variant::kPadding;
+    }
+
+    // Returns whether the source is exhausted. Bulk reads come up short only at the end, which also covers
+    // sources whose IsEndOfStream() cannot see the end coming.
+    bool RefillInput() {
+        if (carryLen_ == 0 && !IsSkippingSpace() && src_->IsCanView()) {
+            const size_t want = (bufferSize_ + 3) / 4 * 4;
+            input_ = src_->ReadView(want);
+            return input_.size() < want || src_->IsEndOfStream();
+        }
+        in_.resize(carryLen_ + bufferSize_);
+        std::copy_n(carry_.begin(), carryLen_, in_.begin());
+        const size_t read = src_->Read(std::span<char>(in_).subspan(carryLen_));
+        const bool ended = read < bufferSize_ || src_->IsEndOfStream();
+        auto end = in_.begin() + static_cast<std::ptrdiff_t>(carryLen_ + read);
+        if (IsSkippingSpace()) {
+            end = std::remove_if(in_.begin() + static_cast<std::ptrdiff_t>(carryLen_), end, IsSpace);
+        }
+        in_.erase(end, in_.end());
+        carryLen_ = 0;
+        input_ = in_;
+        return ended;
+    }
+
+    // Decodes a final quartet, possibly shortened by missing padding.
+    size_t DecodeFinal(const char* in, size_t n, uint8_t* out) {
+        size_t significant = n;
+        while (significant > 0 && in[significant - 1] == '=') {
+            --significant;
+        }
+        const size_t written =
+            significant < 4
+                ? Base64DecodeTail<Variant::kAlphabet>(in, significant, out, mode_ == Base64DecodeMode::Strict)
+                : 0;
+        if (written == 0) {
+            throw std::runtime_error("Invalid base64 input");
+        }
+        return written;
+    }
+
+    void DecodeBlock(bool last) {
+        if (padded_ && !input_.empty()) {
+            throw std::runtime_error("Unexpected base64 data after padding");
+        }
+        out_.resize(input_.size() / 4 * 3 + 2);
+
+        size_t consumed = Base64DecodeQuartets<Variant::kAlphabet>(kernel_, input_.data(), input_.size(), out_.data());
+        size_t written = consumed / 4 * 3;
+        if (input_.size() - consumed >= 4) {
+            // The kernel stopped at a quartet with a char outside the alphabet, which is only valid
+            // as the padded final quartet.
+            written += DecodeFinal(input_.data() + consumed, 4, out_.data() + written);
+            consumed += 4;
+            padded_ = true;
+            if (consumed != input_.size()) {
+                throw std::runtime_error("Unexpected base64 data after padding");
+            }
+        }
+
+        const size_t rem = input_.size() - consumed;
+        if (rem != 0) {
+            if (!last) {
+                carryLen_ = rem;
+                std::copy_n(input_.data() + consumed, rem, carry_.begin());
+            } else if (IsPaddingRequired()) {
+                throw std::runtime_error("Base64 input is not padded");
+            } else {
+                written += DecodeFinal(input_.data() + consumed, rem, out_.data() + written);
+            }
+        }
+        out_.resize(written);
+    }
+
+    void ProduceOutput() {
+        out_.clear();
+        outPos_ = 0;
+
+        while (out_.empty() && !inputDone_) {
+            const bool srcEndedNow = RefillInput();
+            DecodeBlock(srcEndedNow);
+            if (srcEndedNow) {
+                inputDone_ = true;
+            }
+        }
+    }
+};
+
+using Base64DecodeStream = BasicBase64DecodeStream<Base64Standard>;
+using Base64UrlDecodeStream = BasicBase64DecodeStream<Base64Url>;
+using Base64MimeDecodeStream = BasicBase64DecodeStream<Base64Mime>;
@@ -3,16 +3,24 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
-#include <string_view>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
+#include "base64_kernel.hpp"
+#include "base64_variant.hpp"
 #include "fwd.hpp"
 #include "stream.hpp"
 
-class Base64EncodeStream : public ReadOnlyStream<char> {
+template <typename Variant = Base64Standard>
+class BasicBase64EncodeStream : public ReadOnlyStream<char> {
 public:
-    explicit Base64EncodeStream(std::unique_ptr<ReadOnlyStream<uint8_t>> src, size_t bufferSizeBytes = 3)
-        : src_(std::move(src)), bufferSize_(std::max<size_t>(1, bufferSizeBytes)) {
+    using ReadOnlyStream<char>::Read;
+
+    explicit BasicBase64EncodeStream(std::unique_ptr<ReadOnlyStream<uint8_t>> src, size_t bufferSizeBytes = 3,
+                                     Base64Kernel kernel = Base64BestKernel())
+        : src_(std::move(src)), bufferSize_(std::max<size_t>(1, bufferSizeBytes)), kernel_(kernel) {
     }
 
     bool IsEndOfStream() const override {
@@ -20,23 +28,48 @@ public:
     }
 
     char Read() override {
-        if (IsEndOfStream()) {
-            throw std::runtime_error("End of stream ");
+        const std::optional<char> c = TryRead();
+        if (!c) {
+            throw std::runtime_error("End of stream");
         }
+        return *c;
+    }
 
+    std::optional<char> TryRead() override {
         if (outPos_ >= out_.size()) {
+            if (inputDone_) {
+                return std::nullopt;
+            }
             ProduceOutput();
+            if (out_.empty()) {
+                return std::nullopt;
+            }
         }
-
-        if (out_.empty()) {
-            inputDone_ = true;
-            throw std::runtime_error("End of stream");
-        }
-
         count_++;
         return out_[outPos_++];
     }
 
+    size_t Read(std::span<char> out) override {
+        size_t n = 0;
+        while (n < out.size()) {
+            if (outPos_ >= out_.size()) {
+                if (inputDone_) {
+                    break;
+                }
+                ProduceOutput();
+                if (out_.empty()) {
+                    break;
+                }
+            }
+            const size_t chunk = std::min(out.size() - n, out_.size() - outPos_);
+            std::copy_n(out_.data() + outPos_, chunk, out.data() + n);
+            outPos_ += chunk;
+            n += chunk;
+        }
+        count_ += n;
+        return n;
+    }
+
     size_t GetPosition() const override {
         return count_;
     }
@@ -53,16 +86,11 @@ public:
         return false;
     }
 
-private:
-    static constexpr std::string_view kTable =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
-
 private:
     std::unique_ptr<ReadOnlyStream<uint8_t>> src_;
 
     const size_t bufferSize_;
+    const Base64Kernel kernel_;
 
     std::vector<char> out_;
     size_t outPos_ = 0;
@@ -70,47 +98,33 @@ private:
     std::array<uint8_t, 2> carry_{};
     size_t carryLen_ = 0;
 
+    // Chars already written to the current output line.
+    size_t column_ = 0;
+    std::vector<char> unwrapped_;
+
     std::vector<uint8_t> in_;
+    // The block being encoded: either in_ or a zero-copy view of the source.
+    std::span<const uint8_t> input_;
 
     size_t count_ = 0;
     bool inputDone_ = false;
 
-    void RefillInput() {
-        in_.clear();
-        in_.reserve(carryLen_ + bufferSize_);
-        for (size_t i = 0; i < carryLen_; ++i) {
-            in_.push_back(carry_[i]);
+    // Returns whether the source is exhausted. Bulk reads come up short only at the end, which also covers
+    // sources whose IsEndOfStream() cannot see the end coming.
+    bool RefillInput() {
+        if (carryLen_ == 0 && src_->IsCanView()) {
+            // Ask for whole triplets so that a carry is only needed at the very end.
+            const size_t want = (bufferSize_ + 2) / 3 * 3;
+            input_ = src_->ReadView(want);
+            return input_.size() < want || src_->IsEndOfStream();
         }
+        in_.resize(carryLen_ + bufferSize_);
+        std::copy_n(carry_.begin(), carryLen_, in_.begin());
+        const size_t read = src_->Read(std::span<uint8_t>(in_).subspan(carryLen_));
+        in_.resize(carryLen_ + read);
         carryLen_ = 0;
-
-        for (size_t i = 0; i < bufferSize_ && !src_->IsEndOfStream(); ++i) {
-            in_.push_back(src_->Read());
-        }
-    }
-
-    void EncodeTriplet(uint8_t b0, uint8_t b1, uint8_t b2) {
-        const uint32_t triple =
-            (static_cast<uint32_t>(b0) << 16) | (static_cast<uint32_t>(b1) << 8) | static_cast<uint32_t>(b2);
-        out_.push_back(kTable[(triple >> 18) & 63]);
-        out_.push_back(kTable[(triple >> 12) & 63]);
-        out_.push_back(kTable[(triple >> 6) & 63]);
-        out_.push_back(kTable[triple & 63]);
-    }
-
-    void EncodeFinal(uint8_t b0, uint8_t b1, size_t rem) {
-        // rem is 1 or 2
-        uint32_t triple = (static_cast<uint32_t>(b0) << 16);
-        if (rem == 2) {
-            triple |= (static_cast<uint32_t>(b1) << 8);
-        }
-        out_.push_back(kTable[(triple >> 18) & 63]);
-        out_.push_back(kTable[(triple >> 12) & 63]);
-        if (rem == 2) {
-            out_.push_back(kTable[(triple >> 6) & 63]);
-        } else {
-            out_.push_back('=');
-        }
-        out_.push_back('=');
+        input_ = in_;
+        return read < bufferSize_ || src_->IsEndOfStream();
     }
 
     void ProduceOutput() {
@@ -118,40 +132,69 @@ private:
         outPos_ = 0;
 
         while (out_.empty() && !inputDone_) {
-            RefillInput();
+            const bool srcEndedNow = RefillInput();
 
-            if (in_.empty()) {
+            if (input_.empty()) {
                 inputDone_ = true;
                 return;
             }
 
-            const bool srcEndedNow = src_->IsEndOfStream();
-            const size_t n = in_.size();
+            const size_t n = input_.size();
             const size_t fullTriples = n / 3;
             const size_t rem = n % 3;
 
-            out_.reserve(fullTriples * 4 + (rem ? 4 : 0));
-
-            for (size_t i = 0; i < fullTriples; ++i) {
-                const size_t off = i * 3;
-                EncodeTriplet(in_[off], in_[off + 1], in_[off + 2]);
-            }
+            std::vector<char>& encoded = Variant::kLineLength != 0 ? unwrapped_ : out_;
+            encoded.reserve(fullTriples * 4 + (rem ? 4 : 0));
+            encoded.resize(fullTriples * 4);
+            Base64EncodeTriplets<Variant::kAlphabet>(kernel_, input_.data(), n, encoded.data());
 
             if (rem != 0) {
                 const size_t off = fullTriples * 3;
                 if (srcEndedNow) {
-                    EncodeFinal(in_[off], (rem == 2 ? in_[off + 1] : 0), rem);
+                    encoded.resize(encoded.size() + 4);
+                    Base64EncodeTail<Variant::kAlphabet>(input_.data() + off, rem, encoded.data() + fullTriples * 4);
+                    if constexpr (!Variant::kPadding) {
+                        encoded.resize(encoded.size() - 3 + rem);
+                    }
                     inputDone_ = true;
                 } else {
                     carryLen_ = rem;
-                    carry_[0] = in_[off];
+                    carry_[0] = input_[off];
                     if (rem == 2) {
-                        carry_[1] = in_[off + 1];
+                        carry_[1] = input_[off + 1];
                     }
                 }
             } else if (srcEndedNow) {
                 inputDone_ = true;
             }
+
+            if constexpr (Variant::kLineLength != 0) {
+                WrapLines();
+            }
+        }
+    }
+
+    // Copies unwrapped_ into out_, breaking lines with "\r\n". A break is only emitted before the next
+    // char, so the output never ends with an empty line.
+    void WrapLines() {
+        out_.clear();
+        out_.reserve(unwrapped_.size() + (unwrapped_.size() / Variant::kLineLength + 1) * 2);
+        size_t pos = 0;
+        while (pos < unwrapped_.size()) {
+            if (column_ == Variant::kLineLength) {
+                out_.push_back('\r');
+                out_.push_back('\n');
+                column_ = 0;
+            }
+            const size_t chunk = std::min(Variant::kLineLength - column_, unwrapped_.size() - pos);
+            out_.insert(out_.end(), unwrapped_.begin() + static_cast<std::ptrdiff_t>(pos),
+                        unwrapped_.begin() + static_cast<std::ptrdiff_t>(pos + chunk));
+            pos += chunk;
+            column_ += chunk;
         }
     }
 };
+
+using Base64EncodeStream = BasicBase64EncodeStream<Base64Standard>;
+using Base64UrlEncodeStream = BasicBase64EncodeStream<Base64Url>;
+using Base64MimeEncodeStream = BasicBase64EncodeStream<Base64Mime>;
@@ -0,0 +1,439 @@
+#include "base64_kernel.hpp"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LAB1_BASE64_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <Base64Alphabet A>
+constexpr std::string_view kTable = A == Base64Alphabet::Url ? "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                                               "abcdefghijklmnopqrstuvwxyz"
+                                                               "0123456789-_"
+                                                             : "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                                               "abcdefghijklmnopqrstuvwxyz"
+                                                               "0123456789+/";
+
+template <Base64Alphabet A>
+size_t EncodeScalar(const uint8_t* in, size_t n, char* out) {
+    const size_t full = n / 3 * 3;
+    for (size_t i = 0; i < full; i += 3) {
+        const uint32_t triple =
+            (static_cast<uint32_t>(in[i]) << 16) | (static_cast<uint32_t>(in[i + 1]) << 8) | in[i + 2];
+        out[0] = kTable<A>[(triple >> 18) & 63];
+        out[1] = kTable<A>[(triple >> 12) & 63];
+        out[2] = kTable<A>[(triple >> 6) & 63];
+        out[3] = kTable<A>[triple & 63];
+        out += 4;
+    }
+    return full;
+}
+
+template <Base64Alphabet A>
+constexpr std::array<int8_t, 256> MakeDecodeTable() {
+    std::array<int8_t, 256> table{};
+    table.fill(-1);
+    for (size_t i = 0; i < kTable<A>.size(); ++i) {
+        table[static_cast<uint8_t>(kTable<A>[i])] = static_cast<int8_t>(i);
+    }
+    return table;
+}
+
+template <Base64Alphabet A>
+constexpr std::array<int8_t, 256> kDecodeTable = MakeDecodeTable<A>();
+
+template <Base64Alphabet A>
+size_t DecodeScalar(const char* in, size_t n, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const int a = kDecodeTable<A>[static_cast<uint8_t>(in[i])];
+        const int b = kDecodeTable<A>[static_cast<uint8_t>(in[i + 1])];
+        const int c = kDecodeTable<A>[static_cast<uint8_t>(in[i + 2])];
+        const int d = kDecodeTable<A>[static_cast<uint8_t>(in[i + 3])];
+        if ((a | b | c | d) < 0) {
+            break;
+        }
+        const uint32_t triple = (static_cast<uint32_t>(a) << 18) | (static_cast<uint32_t>(b) << 12) |
+                                (static_cast<uint32_t>(c) << 6) | static_cast<uint32_t>(d);
+        out[0] = static_cast<uint8_t>(triple >> 16);
+        out[1] = static_cast<uint8_t>(triple >> 8);
+        out[2] = static_cast<uint8_t>(triple);
+        out += 3;
+    }
+    return i;
+}
+
+#ifdef LAB1_BASE64_X86
+
+// The 128-bit kernels follow W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+// Instructions": every 32-bit lane receives bytes (1, 0, 2, 1) of a triplet, the four 6-bit indices
+// are moved into separate bytes with two multiplies, and the indices are turned into ASCII by adding
+// a per-range offset looked up with pshufb. Only the offsets of chars 62 and 63 depend on the alphabet.
+
+__attribute__((target("ssse3"))) inline __m128i SplitIndices(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+template <Base64Alphabet A>
+__attribute__((target("ssse3"))) inline __m128i IndicesToAscii(__m128i indices) {
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+    __m128i offsetIndex = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    offsetIndex = _mm_or_si128(offsetIndex, _mm_and_si128(less, _mm_set1_epi8(13)));
+    constexpr char k62 = static_cast<char>(kTable<A>[62] - 62);
+    constexpr char k63 = static_cast<char>(kTable<A>[63] - 63);
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, k62, k63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, offsetIndex), indices);
+}
+
+template <Base64Alphabet A>
+__attribute__((target("ssse3"))) size_t EncodeSsse3(const uint8_t* in, size_t n, char* out) {
+    size_t i = 0;
+    // Each step loads 16 bytes and consumes 12 of them.
+    for (; i + 16 <= n; i += 12) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), IndicesToAscii<A>(SplitIndices(v)));
+        out += 16;
+    }
+    return i + EncodeScalar<A>(in + i, n - i, out);
+}
+
+__attribute__((target("avx2"))) inline __m256i SplitIndices(__m256i in) {
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7,
+                                                 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(t1, t3);
+}
+
+template <Base64Alphabet A>
+__attribute__((target("avx2"))) inline __m256i IndicesToAscii(__m256i indices) {
+    __m256i offsetIndex = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    offsetIndex = _mm256_or_si256(offsetIndex, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    constexpr char k62 = static_cast<char>(kTable<A>[62] - 62);
+    constexpr char k63 = static_cast<char>(kTable<A>[63] - 63);
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, k62, k63, 'A', 0, 0, 'a' - 26,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, k62, k63, 'A', 0, 0);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, offsetIndex), indices);
+}
+
+template <Base64Alphabet A>
+__attribute__((target("avx2"))) size_t EncodeAvx2(const uint8_t* in, size_t n, char* out) {
+    size_t i = 0;
+    // Each step consumes 24 bytes: two 16-byte loads at +0 and +12, one per 128-bit lane.
+    for (; i + 28 <= n; i += 24) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+        const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), IndicesToAscii<A>(SplitIndices(v)));
+        out += 32;
+    }
+    return i + EncodeSsse3<A>(in + i, n - i, out);
+}
+
+template <Base64Alphabet A>
+__attribute__((target("avx512f,avx512bw,avx512vbmi"))) size_t EncodeAvx512(const uint8_t* in, size_t n, char* out) {
+    // Bytes (1, 0, 2, 1) of every triplet go to each 32-bit lane, then vpmultishiftqb extracts the
+    // four 6-bit fields and vpermb maps them through the 64-char alphabet directly.
+    const __m512i shuffle = _mm512_setr_epi32(0x01020001, 0x04050304, 0x07080607, 0x0a0b090a, 0x0d0e0c0d, 0x10110f10,
+                                              0x13141213, 0x16171516, 0x191a1819, 0x1c1d1b1c, 0x1f201e1f, 0x22232122,
+                                              0x25262425, 0x28292728, 0x2b2c2a2b, 0x2e2f2d2e);
+    const __m512i shifts = _mm512_set1_epi64(0x3036242a1016040a);
+    const __m512i table = _mm512_loadu_si512(kTable<A>.data());
+    const __mmask64 loadMask = 0x0000ffffffffffffULL;
+
+    size_t i = 0;
+    for (; i + 48 <= n; i += 48) {
+        const __m512i v = _mm512_maskz_loadu_epi8(loadMask, in + i);
+        const __m512i indices = _mm512_multishift_epi64_epi8(shifts, _mm512_permutexvar_epi8(shuffle, v));
+        _mm512_storeu_si512(out, _mm512_permutexvar_epi8(indices, table));
+        out += 64;
+    }
+    return i + EncodeAvx2<A>(in + i, n - i, out);
+}
+
+// Decoding classifies every char by range compares, which validates it and yields the offset that turns
+// it into its 6-bit value. maddubs/madd then merge four values into a 24-bit word per 32-bit lane and a
+// byte shuffle drops the empty fourth byte. A block with an invalid char is left to the scalar kernel,
+// which stops at the exact quartet.
+
+template <Base64Alphabet A>
+__attribute__((target("ssse3"))) inline bool TranslateChars(__m128i in, __m128i* values) {
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(in, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(in, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+    const __m128i c62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(kTable<A>[62]));
+    const __m128i c63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(kTable<A>[63]));
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(c62, c63)));
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+        return false;
+    }
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(c62, _mm_set1_epi8(static_cast<char>(62 - kTable<A>[62]))));
+    shift = _mm_or_si128(shift, _mm_and_si128(c63, _mm_set1_epi8(static_cast<char>(63 - kTable<A>[63]))));
+    *values = _mm_add_epi8(in, shift);
+    return true;
+}
+
+__attribute__((target("ssse3"))) inline __m128i PackValues(__m128i values) {
+    const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)),
+                                          _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+template <Base64Alphabet A>
+__attribute__((target("ssse3"))) size_t DecodeSsse3(const char* in, size_t n, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i values;
+        if (!TranslateChars<A>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), &values)) {
+            break;
+        }
+        const __m128i packed = PackValues(values);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+        const uint32_t rest = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+        std::memcpy(out + 8, &rest, 4);
+        out += 12;
+    }
+    return i + DecodeScalar<A>(in + i, n - i, out);
+}
+
+template <Base64Alphabet A>
+__attribute__((target("avx2"))) inline bool TranslateChars(__m256i in, __m256i* values) {
+    const __m256i upper = _mm256_andnot_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('Z')),
+                                              _mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)));
+    const __m256i lower = _mm256_andnot_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('z')),
+                                              _mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)));
+    const __m256i digit = _mm256_andnot_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('9')),
+                                              _mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)));
+    const __m256i c62 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(kTable<A>[62]));
+    const __m256i c63 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(kTable<A>[63]));
+    const __m256i valid =
+        _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(c62, c63)));
+    if (_mm256_movemask_epi8(valid) != -1) {
+        return false;
+    }
+    __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(c62, _mm256_set1_epi8(static_cast<char>(62 - kTable<A>[62]))));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(c63, _mm256_set1_epi8(static_cast<char>(63 - kTable<A>[63]))));
+    *values = _mm256_add_epi8(in, shift);
+    return true;
+}
+
+template <Base64Alphabet A>
+__attribute__((target("avx2"))) size_t DecodeAvx2(const char* in, size_t n, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i values;
+        if (!TranslateChars<A>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), &values)) {
+            break;
+        }
+        __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)),
+                                           _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                              2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // 12 bytes sit at the start of each lane; gather them into the low 24 bytes.
+        merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(merged));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(merged, 1));
+        out += 24;
+    }
+    return i + DecodeSsse3<A>(in + i, n - i, out);
+}
+
+template <Base64Alphabet A>
+constexpr std::array<uint8_t, 128> MakeVbmiDecodeTable() {
+    std::array<uint8_t, 128> table{};
+    table.fill(0x80);
+    for (size_t i = 0; i < kTable<A>.size(); ++i) {
+        table[static_cast<uint8_t>(kTable<A>[i])] = static_cast<uint8_t>(i);
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 64> MakeVbmiPackIndices() {
+    std::array<uint8_t, 64> indices{};
+    for (uint8_t lane = 0; lane < 16; ++lane) {
+        indices[lane * 3] = static_cast<uint8_t>(lane * 4 + 2);
+        indices[lane * 3 + 1] = static_cast<uint8_t>(lane * 4 + 1);
+        indices[lane * 3 + 2] = static_cast<uint8_t>(lane * 4);
+    }
+    return indices;
+}
+
+template <Base64Alphabet A>
+alignas(64) constexpr std::array<uint8_t, 128> kVbmiDecodeTable = MakeVbmiDecodeTable<A>();
+alignas(64) constexpr std::array<uint8_t, 64> kVbmiPackIndices = MakeVbmiPackIndices();
+
+template <Base64Alphabet A>
+__attribute__((target("avx512f,avx512bw,avx512vbmi"))) size_t DecodeAvx512(const char* in, size_t n, uint8_t* out) {
+    // vpermi2b looks every char up in a 128-entry table where invalid chars map to 0x80; chars above
+    // 127 keep their own high bit, so one sign-bit test validates the whole block.
+    const __m512i tableLo = _mm512_load_si512(kVbmiDecodeTable<A>.data());
+    const __m512i tableHi = _mm512_load_si512(kVbmiDecodeTable<A>.data() + 64);
+    const __m512i pack = _mm512_load_si512(kVbmiPackIndices.data());
+    const __mmask64 storeMask = 0x0000ffffffffffffULL;
+
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        const __m512i chars = _mm512_loadu_si512(in + i);
+        const __m512i values = _mm512_permutex2var_epi8(tableLo, chars, tableHi);
+        if (_mm512_movepi8_mask(_mm512_or_si512(values, chars)) != 0) {
+            break;
+        }
+        const __m512i merged = _mm512_madd_epi16(_mm512_maddubs_epi16(values, _mm512_set1_epi32(0x01400140)),
+                                                 _mm512_set1_epi32(0x00011000));
+        _mm512_mask_storeu_epi8(out, storeMask, _mm512_permutexvar_epi8(pack, merged));
+        out += 48;
+    }
+    return i + DecodeAvx2<A>(in + i, n - i, out);
+}
+
+#endif
+
+Base64Kernel DetectKernel() {
+#ifdef LAB1_BASE64_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vbmi")) {
+        return Base64Kernel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Base64Kernel::Avx2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return Base64Kernel::Ssse3;
+    }
+#endif
+    return Base64Kernel::Scalar;
+}
+
+}  // namespace
+
+Base64Kernel Base64BestKernel() {
+    static const Base64Kernel kernel = DetectKernel();
+    return kernel;
+}
+
+bool Base64IsKernelSupported(Base64Kernel kernel) {
+    return static_cast<int>(kernel) <= static_cast<int>(Base64BestKernel());
+}
+
+const char* Base64KernelName(Base64Kernel kernel) {
+    switch (kernel) {
+        case Base64Kernel::Scalar:
+            return "scalar";
+        case Base64Kernel::Ssse3:
+            return "ssse3";
+        case Base64Kernel::Avx2:
+            return "avx2";
+        case Base64Kernel::Avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+template <Base64Alphabet A>
+size_t Base64EncodeTriplets(Base64Kernel kernel, const uint8_t* in, size_t n, char* out) {
+    if (!Base64IsKernelSupported(kernel)) {
+        kernel = Base64BestKernel();
+    }
+    switch (kernel) {
+#ifdef LAB1_BASE64_X86
+        case Base64Kernel::Avx512:
+            return EncodeAvx512<A>(in, n, out);
+        case Base64Kernel::Avx2:
+            return EncodeAvx2<A>(in, n, out);
+        case Base64Kernel::Ssse3:
+            return EncodeSsse3<A>(in, n, out);
+#endif
+        default:
+            return EncodeScalar<A>(in, n, out);
+    }
+}
+
+template <Base64Alphabet A>
+void Base64EncodeTail(const uint8_t* in, size_t n, char* out) {
+    uint32_t triple = static_cast<uint32_t>(in[0]) << 16;
+    if (n == 2) {
+        triple |= static_cast<uint32_t>(in[1]) << 8;
+    }
+    out[0] = kTable<A>[(triple >> 18) & 63];
+    out[1] = kTable<A>[(triple >> 12) & 63];
+    out[2] = n == 2 ? kTable<A>[(triple >> 6) & 63] : '=';
+    out[3] = '=';
+}
+
+template <Base64Alphabet A>
+size_t Base64DecodeQuartets(Base64Kernel kernel, const char* in, size_t n, uint8_t* out) {
+    if (!Base64IsKernelSupported(kernel)) {
+        kernel = Base64BestKernel();
+    }
+    switch (kernel) {
+#ifdef LAB1_BASE64_X86
+        case Base64Kernel::Avx512:
+            return DecodeAvx512<A>(in, n, out);
+        case Base64Kernel::Avx2:
+            return DecodeAvx2<A>(in, n, out);
+        case Base64Kernel::Ssse3:
+            return DecodeSsse3<A>(in, n, out);
+#endif
+        default:
+            return DecodeScalar<A>(in, n, out);
+    }
+}
+
+template <Base64Alphabet A>
+size_t Base64DecodeTail(const char* in, size_t n, uint8_t* out, bool canonical) {
+    if (n != 2 && n != 3) {
+        return 0;
+    }
+    uint32_t triple = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const int value = kDecodeTable<A>[static_cast<uint8_t>(in[i])];
+        if (value < 0) {
+            return 0;
+        }
+        triple |= static_cast<uint32_t>(value) << (18 - 6 * i);
+    }
+    if (canonical && (triple & (n == 2 ? 0xFFFF : 0xFF)) != 0) {
+        return 0;
+    }
+    out[0] = static_cast<uint8_t>(triple >> 16);
+    if (n == 3) {
+        out[1] = static_cast<uint8_t>(triple >> 8);
+    }
+    return n - 1;
+}
+
+template size_t Base64EncodeTriplets<Base64Alphabet::Standard>(Base64Kernel, const uint8_t*, size_t, char*);
+template size_t Base64EncodeTriplets<Base64Alphabet::Url>(Base64Kernel, const uint8_t*, size_t, char*);
+template void Base64EncodeTail<Base64Alphabet::Standard>(const uint8_t*, size_t, char*);
+template void Base64EncodeTail<Base64Alphabet::Url>(const uint8_t*, size_t, char*);
+template size_t Base64DecodeQuartets<Base64Alphabet::Standard>(Base64Kernel, const char*, size_t, uint8_t*);
+template size_t Base64DecodeQuartets<Base64Alphabet::Url>(Base64Kernel, const char*, size_t, uint8_t*);
+template size_t Base64DecodeTail<Base64Alphabet::Standard>(const char*, size_t, uint8_t*, bool);
+template size_t Base64DecodeTail<Base64Alphabet::Url>(const char*, size_t, uint8_t*, bool);
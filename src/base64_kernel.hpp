@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Block codecs used by the Base64 streams, instantiated for both alphabets in base64_kernel.cpp. Vector kernels
+// encode 12 (SSSE3), 24 (AVX2) or 48 (AVX-512 VBMI) input bytes per step and decode 16, 32 or 64 chars per step;
+// the scalar kernel is the reference and the fallback.
+enum class Base64Kernel {
+    Scalar,
+    Ssse3,
+    Avx2,
+    Avx512,
+};
+
+// The two RFC 4648 alphabets; they differ only in chars 62 and 63 ("+/" and "-_").
+enum class Base64Alphabet {
+    Standard,
+    Url,
+};
+
+// Fastest kernel supported by the running CPU, detected once.
+Base64Kernel Base64BestKernel();
+
+bool Base64IsKernelSupported(Base64Kernel kernel);
+
+const char* Base64KernelName(Base64Kernel kernel);
+
+// Encodes every full triplet of in[0, n) into out, 4 chars per triplet.
+// Returns the number of consumed input bytes, i.e. n / 3 * 3. The tail is left to the caller.
+template <Base64Alphabet A = Base64Alphabet::Standard>
+size_t Base64EncodeTriplets(Base64Kernel kernel, const uint8_t* in, size_t n, char* out);
+
+// Encodes the last 1 or 2 input bytes as 4 chars with '=' padding.
+template <Base64Alphabet A = Base64Alphabet::Standard>
+void Base64EncodeTail(const uint8_t* in, size_t n, char* out);
+
+// Decodes and validates full quartets of in[0, n) into out, 3 bytes per quartet, and stops before the
+// first quartet holding a char outside the alphabet ('=' and whitespace included).
+// Returns the number of consumed chars, a multiple of 4.
+template <Base64Alphabet A = Base64Alphabet::Standard>
+size_t Base64DecodeQuartets(Base64Kernel kernel, const char* in, size_t n, uint8_t* out);
+
+// Decodes the 2 or 3 significant chars of a final quartet whose padding is already stripped.
+// Returns the number of written bytes (1 or 2), or 0 if the input is not valid. With canonical, the bits of the
+// last char that fall past the final byte must be zero, as an encoder leaves them.
+template <Base64Alphabet A = Base64Alphabet::Standard>
+size_t Base64DecodeTail(const char* in, size_t n, uint8_t* out, bool canonical = false);
+
+inline size_t Base64EncodedLength(size_t n) {
+    return (n + 2) / 3 * 4;
+}
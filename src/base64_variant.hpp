@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#include "base64_kernel.hpp"
+
+// Compile-time policies selecting the Base64 flavour of the encode and decode streams. A variant provides
+// the alphabet, whether the final quartet is padded with '=', and the line length after which the encoder
+// inserts "\r\n" (0 disables wrapping).
+
+// RFC 4648 section 4.
+struct Base64Standard {
+    static constexpr Base64Alphabet kAlphabet = Base64Alphabet::Standard;
+    static constexpr bool kPadding = true;
+    static constexpr size_t kLineLength = 0;
+};
+
+// RFC 4648 section 5, without padding as used in URLs and JWTs.
+struct Base64Url {
+    static constexpr Base64Alphabet kAlphabet = Base64Alphabet::Url;
+    static constexpr bool kPadding = false;
+    static constexpr size_t kLineLength = 0;
+};
+
+// RFC 2045: standard alphabet, lines of at most 76 chars.
+struct Base64Mime {
+    static constexpr Base64Alphabet kAlphabet = Base64Alphabet::Standard;
+    static constexpr bool kPadding = true;
+    static constexpr size_t kLineLength = 76;
+};
@@ -33,7 +33,7 @@ bool Cardinal::operator<(const Cardinal& other) const {
 }
 
 Cardinal Cardinal::operator+(const Cardinal& m) const {
-    return cardinal_ == Cardinals::N0 ? Cardinal(cardinal_) : Cardinal(n_ + m.n_);
+    return IsFinite() && m.IsFinite() ? Cardinal(n_ + m.n_) : Cardinal(Cardinals::N0);
 }
 
 Cardinal Cardinal::operator-(size_t m) const {
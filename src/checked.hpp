@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef LAB1_CHECKED
+inline constexpr bool kChecked = true;
+#else
+inline constexpr bool kChecked = false;
+#endif
+
+// The bounds check of operator[] and the other unchecked accessors. With LAB1_CHECKED, which Debug builds define,
+// it throws like Get; otherwise it compiles to nothing and an index out of range is undefined behavior, as with
+// std::vector::operator[].
+inline void CheckIndex(size_t index, size_t size) {
+    if constexpr (kChecked) {
+        if (index >= size) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size));
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "cardinal.hpp"
+#include "lazy_sequence.hpp"
+#include "segmented_storage.hpp"
+
+// A LazySequence that many threads can read at once. Reads of materialized items take no lock: they load the
+// published size and index into SegmentedStorage. A read past the materialized prefix takes the writer lock and
+// copies blocks from the source until the index is materialized, so the source is only ever used by one thread.
+// References returned by GetIndex stay valid for the lifetime of the sequence.
+template <typename T>
+class ConcurrentLazySequence {
+public:
+    // Takes exclusive use of source: nobody else may read or extend it afterwards. Its memoization is cut to one
+    // block, since every item is kept here.
+    explicit ConcurrentLazySequence(LazySequencePtr<T> source) : source_(std::move(source)) {
+        source_->SetMemoization(Memoization::Window(kBlockSize));
+    }
+
+    ConcurrentLazySequence(const ConcurrentLazySequence&) = delete;
+    ConcurrentLazySequence& operator=(const ConcurrentLazySequence&) = delete;
+
+    const T& GetIndex(size_t index) const {
+        if (!HasIndex(index)) {
+            throw std::out_of_range("GetIndex: no item at index " + std::to_string(index));
+        }
+        return items_.Get(index);
+    }
+
+    // Materializes the sequence through index; false if it ends before.
+    bool HasIndex(size_t index) const {
+        if (index < items_.GetSize()) {
+            return true;
+        }
+        Materialize(index + 1);
+        return index < items_.GetSize();
+    }
+
+    Cardinal GetLength() const {
+        return source_->GetLength();
+    }
+
+    size_t GetMaterializedCount() const {
+        return items_.GetSize();
+    }
+
+private:
+    static constexpr size_t kBlockSize = SegmentedStorage<T>::kFirstSegment;
+
+    const LazySequencePtr<T> source_;
+    mutable std::mutex mutex_;
+    mutable SegmentedStorage<T> items_;
+
+    void Materialize(size_t count) const {
+        std::lock_guard lock(mutex_);
+        // Blocks are published one by one, so lock-free readers see early items while later ones are generated.
+        while (items_.GetSize() < count) {
+            const std::span<const T> block = source_->GetBlock(items_.GetSize(), kBlockSize);
+            if (block.empty()) {
+                return;
+            }
+            items_.AppendRange(block);
+        }
+    }
+};
@@ -1,102 +1,266 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 
-template <class T>
+#include "checked.hpp"
+
+// A contiguous array over raw storage: only the first GetSize() slots hold constructed objects, the rest
+// up to GetCapacity() are uninitialized. Storage comes from Allocator, e.g. std::pmr::polymorphic_allocator
+// over an arena from arena.hpp. With the default std::allocator, trivially copyable types live in malloc'ed
+// memory that grows with realloc; other types are relocated with move_if_noexcept.
+template <class T, class Allocator = std::allocator<T>>
 class DynamicArray {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static constexpr bool kIsTrivial = std::is_trivially_copyable_v<T>;
+    static constexpr bool kIsReallocatable = kIsTrivial && alignof(T) <= alignof(std::max_align_t) &&
+                                             std::is_same_v<Allocator, std::allocator<T>>;
+
 public:
-    DynamicArray(const T* items, size_t count) : size_(count) {
-        data_ = new T[size_]();
-        for (size_t i = 0; i < size_; ++i) {
-            data_[i] = items[i];
-        }
+    // No allocator_type: without allocator-extended copy and move constructors, uses-allocator construction
+    // (std::pmr::polymorphic_allocator::construct) would pass the allocator as an extra argument.
+    DynamicArray(const T* items, size_t count, const Allocator& alloc = Allocator()) : alloc_(alloc) {
+        Reallocate(count);
+        ConstructCopies(items, count, data_);
+        size_ = count;
     }
 
     DynamicArray() {
     }
 
-    DynamicArray(size_t size) : size_(size) {
-        if (size != 0) {
-            data_ = new T[size]();
-        }
+    explicit DynamicArray(const Allocator& alloc) : alloc_(alloc) {
     }
 
-    DynamicArray(const DynamicArray<T>& v) : size_(v.size_) {
-        if (size_ != 0) {
-            data_ = new T[size_]();
-            for (size_t i = 0; i < size_; ++i) {
-                data_[i] = v.data_[i];
-            }
-        }
+    DynamicArray(size_t size, const Allocator& alloc = Allocator()) : alloc_(alloc) {
+        Resize(size);
     }
 
-    DynamicArray<T>& operator=(const DynamicArray<T>& v) {
-        if (data_ != nullptr) {
-            delete[] data_;
-        }
-        size_ = v.size_;
-        if (size_ != 0) {
-            data_ = new T[size_]();
-            for (size_t i = 0; i < size_; ++i) {
-                data_[i] = v.data_[i];
-            }
+    DynamicArray(const DynamicArray& v)
+        : DynamicArray(v.data_, v.size_, AllocTraits::select_on_container_copy_construction(v.alloc_)) {
+    }
+
+    DynamicArray& operator=(const DynamicArray& v) {
+        if (this != &v) {
+            DynamicArray copy(v.data_, v.size_, alloc_);
+            SwapStorage(copy);
         }
         return *this;
     }
 
-    DynamicArray<T>& operator=(DynamicArray<T>&& v) {
-        if (data_ != nullptr) {
-            delete[] data_;
+    DynamicArray& operator=(DynamicArray&& v) noexcept(AllocTraits::is_always_equal::value ||
+                                                       AllocTraits::propagate_on_container_move_assignment::value) {
+        if (this == &v) {
+            return *this;
+        }
+        if constexpr (AllocTraits::is_always_equal::value ||
+                      AllocTraits::propagate_on_container_move_assignment::value) {
+            DynamicArray tmp(std::move(v));
+            SwapStorage(tmp);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                std::swap(alloc_, tmp.alloc_);
+            }
+        } else if (alloc_ == v.alloc_) {
+            DynamicArray tmp(std::move(v));
+            SwapStorage(tmp);
+        } else {
+            // Memory of another resource cannot be adopted, so the elements are moved one by one.
+            Clear();
+            Reserve(v.size_);
+            for (size_t i = 0; i < v.size_; ++i) {
+                AllocTraits::construct(alloc_, data_ + i, std::move(v.data_[i]));
+                ++size_;
+            }
+            v.Clear();
         }
-        size_ = v.size_;
-        data_ = v.data_;
-        v.size_ = 0;
-        v.data_ = nullptr;
         return *this;
     }
 
-    DynamicArray(DynamicArray<T>&& v) : size_(v.size_), data_(v.data_) {
-        v.size_ = 0;
-        v.data_ = nullptr;
+    DynamicArray(DynamicArray&& v) noexcept
+        : alloc_(std::move(v.alloc_)),
+          size_(std::exchange(v.size_, 0)),
+          capacity_(std::exchange(v.capacity_, 0)),
+          data_(std::exchange(v.data_, nullptr)) {
     }
 
     ~DynamicArray() {
-        if (data_ != nullptr) {
-            delete[] data_;
-        }
+        DestroyRange(0, size_);
+        Deallocate(data_, capacity_);
+    }
+
+    Allocator GetAllocator() const {
+        return alloc_;
     }
 
     const T& Get(size_t index) const {
-        if (index < 0 || index >= size_) {
+        if (index >= size_) {
             throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
         }
         return data_[index];
     }
 
+    // Unchecked unlike Get, except in LAB1_CHECKED builds.
+    T& operator[](size_t index) {
+        CheckIndex(index, size_);
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const {
+        CheckIndex(index, size_);
+        return data_[index];
+    }
+
     size_t GetSize() const {
         return size_;
     }
 
+    size_t GetCapacity() const {
+        return capacity_;
+    }
+
     void Set(size_t index, const T& item) {
-        if (index < 0 || index >= size_) {
+        if (index >= size_) {
             throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
         }
         data_[index] = item;
     }
 
+    // Shrinking destroys the tail and keeps the storage; growing value-initializes the new elements.
     void Resize(size_t newSize) {
-        if (newSize < size_) {
+        if (newSize <= size_) {
+            DestroyRange(newSize, size_);
             size_ = newSize;
             return;
         }
-        T* newData = new T[newSize]();
-        for (size_t i = 0; i < size_; ++i) {
-            newData[i] = data_[i];
+        Reserve(newSize);
+        for (; size_ < newSize; ++size_) {
+            AllocTraits::construct(alloc_, data_ + size_);
+        }
+    }
+
+    // Makes room for capacity elements without constructing any of them.
+    void Reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            Reallocate(capacity);
+        }
+    }
+
+    void Clear() {
+        DestroyRange(0, size_);
+        size_ = 0;
+    }
+
+    void PushBack(const T& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(T&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            // The argument may live in this array, so it is constructed before the storage moves.
+            T item(std::forward<Args>(args)...);
+            Grow(size_ + 1);
+            AllocTraits::construct(alloc_, data_ + size_, std::move(item));
+        } else {
+            AllocTraits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void AppendRange(const T* items, size_t count) {
+        if (size_ + count > capacity_) {
+            // Same aliasing concern as in EmplaceBack.
+            DynamicArray tmp(alloc_);
+            if (items >= data_ && items < data_ + size_) {
+                tmp = DynamicArray(items, count, alloc_);
+                items = tmp.data_;
+            }
+            Grow(size_ + count);
+            ConstructCopies(items, count, data_ + size_);
+        } else {
+            ConstructCopies(items, count, data_ + size_);
+        }
+        size_ += count;
+    }
+
+    // Shifts [index, size) one slot right and puts item at index.
+    void Insert(size_t index, const T& item) {
+        if (index > size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        if (index == size_) {
+            PushBack(item);
+            return;
+        }
+        T copy(item);
+        if (size_ == capacity_) {
+            Grow(size_ + 1);
+        }
+        if constexpr (kIsTrivial) {
+            std::memmove(data_ + index + 1, data_ + index, (size_ - index) * sizeof(T));
+            std::memcpy(data_ + index, &copy, sizeof(T));
+        } else {
+            AllocTraits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+            std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
+            data_[index] = std::move(copy);
+        }
+        ++size_;
+    }
+
+    // Shifts [index, size) count slots right, once, and copies items[0, count) into the gap.
+    void InsertRange(size_t index, const T* items, size_t count) {
+        if (index > size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        const size_t oldSize = size_;
+        if constexpr (kIsTrivial) {
+            if (count == 0) {
+                return;
+            }
+            DynamicArray tmp(alloc_);
+            if (items >= data_ && items < data_ + size_) {
+                tmp = DynamicArray(items, count, alloc_);
+                items = tmp.data_;
+            }
+            if (size_ + count > capacity_) {
+                Grow(size_ + count);
+            }
+            std::memmove(data_ + index + count, data_ + index, (oldSize - index) * sizeof(T));
+            std::memcpy(data_ + index, items, count * sizeof(T));
+            size_ += count;
+        } else {
+            AppendRange(items, count);
+            std::rotate(data_ + index, data_ + oldSize, data_ + size_);
+        }
+    }
+
+    // Removes [index, index + count) and shifts the tail left; the capacity is kept.
+    void Erase(size_t index, size_t count) {
+        if (index > size_ || count > size_ - index) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        if (count == 0) {
+            return;
+        }
+        if constexpr (kIsTrivial) {
+            std::memmove(data_ + index, data_ + index + count, (size_ - index - count) * sizeof(T));
+        } else {
+            std::move(data_ + index + count, data_ + size_, data_ + index);
+            DestroyRange(size_ - count, size_);
         }
-        delete[] data_;
-        data_ = newData;
-        size_ = newSize;
+        size_ -= count;
     }
 
     T* GetBegin() {
@@ -107,7 +271,121 @@ public:
         return data_;
     }
 
+    T* data() {
+        return data_;
+    }
+
+    const T* data() const {
+        return data_;
+    }
+
+    void Swap(DynamicArray& other) noexcept {
+        SwapStorage(other);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
+    }
+
 private:
+    [[no_unique_address]] Allocator alloc_;
     size_t size_ = 0;
+    size_t capacity_ = 0;
     T* data_ = nullptr;
+
+    // Geometric growth keeps a series of appends amortized O(1).
+    void Grow(size_t minCapacity) {
+        Reallocate(std::max(minCapacity, capacity_ * 2));
+    }
+
+    void SwapStorage(DynamicArray& other) noexcept {
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(data_, other.data_);
+    }
+
+    void Reallocate(size_t capacity) {
+        if (capacity == capacity_) {
+            return;
+        }
+        if constexpr (kIsReallocatable) {
+            if (capacity == 0) {
+                std::free(data_);
+                data_ = nullptr;
+            } else {
+                void* p = std::realloc(data_, capacity * sizeof(T));
+                if (p == nullptr) {
+                    throw std::bad_alloc();
+                }
+                data_ = static_cast<T*>(p);
+            }
+        } else {
+            T* newData = Allocate(capacity);
+            if constexpr (kIsTrivial) {
+                if (size_ != 0) {
+                    std::memcpy(newData, data_, size_ * sizeof(T));
+                }
+            } else {
+                size_t moved = 0;
+                try {
+                    for (; moved < size_; ++moved) {
+                        AllocTraits::construct(alloc_, newData + moved, std::move_if_noexcept(data_[moved]));
+                    }
+                } catch (...) {
+                    for (size_t i = 0; i < moved; ++i) {
+                        AllocTraits::destroy(alloc_, newData + i);
+                    }
+                    Deallocate(newData, capacity);
+                    throw;
+                }
+                DestroyRange(0, size_);
+            }
+            Deallocate(data_, capacity_);
+            data_ = newData;
+        }
+        capacity_ = capacity;
+    }
+
+    // Constructs copies of items[0, count) in the uninitialized slots at dst.
+    void ConstructCopies(const T* items, size_t count, T* dst) {
+        if constexpr (kIsTrivial) {
+            if (count != 0) {
+                std::memcpy(dst, items, count * sizeof(T));
+            }
+        } else {
+            size_t done = 0;
+            try {
+                for (; done < count; ++done) {
+                    AllocTraits::construct(alloc_, dst + done, items[done]);
+                }
+            } catch (...) {
+                for (size_t i = 0; i < done; ++i) {
+                    AllocTraits::destroy(alloc_, dst + i);
+                }
+                throw;
+            }
+        }
+    }
+
+    void DestroyRange(size_t begin, size_t end) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = begin; i < end; ++i) {
+                AllocTraits::destroy(alloc_, data_ + i);
+            }
+        }
+    }
+
+    T* Allocate(size_t capacity) {
+        return capacity == 0 ? nullptr : AllocTraits::allocate(alloc_, capacity);
+    }
+
+    void Deallocate(T* data, size_t capacity) {
+        if (data == nullptr) {
+            return;
+        }
+        if constexpr (kIsReallocatable) {
+            std::free(data);
+        } else {
+            AllocTraits::deallocate(alloc_, data, capacity);
+        }
+    }
 };
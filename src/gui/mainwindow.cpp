@@ -1,6 +1,7 @@
 #include "mainwindow.h"
 
 #include <QButtonGroup>
+#include <QComboBox>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QGridLayout>
@@ -18,8 +19,10 @@
 #include <QVBoxLayout>
 #include <chrono>
 #include <memory>
+#include <vector>
 
 #include "base64_encode_stream.hpp"
+#include "mmap_read_stream.hpp"
 #include "random_byte_stream.hpp"
 #include "read_stream.hpp"
 #include "write_stream.hpp"
@@ -28,20 +31,14 @@ namespace {
 
 std::unique_ptr<ReadOnlyStream<uint8_t>> makeTextStream(const QString& text) {
     const QByteArray bytes = text.toUtf8();
-    auto seq = std::make_shared<ArraySequence<uint8_t>>();
-    seq->Clear();
-    for (auto b : bytes) {
-        seq->Append(static_cast<uint8_t>(static_cast<unsigned char>(b)));
-    }
+    const auto* data = reinterpret_cast<const uint8_t*>(bytes.constData());
+    auto seq = std::make_shared<ArraySequence<uint8_t>>(data, data + bytes.size());
     return std::make_unique<SequenceReadStream<uint8_t>>(std::move(seq));
 }
 
 std::unique_ptr<ReadOnlyStream<uint8_t>> makeFileStream(const QString& path, QString* error) {
     try {
-        auto parse = [](std::istream& is) -> uint8_t {
-            return static_cast<uint8_t>(is.get());
-        };
-        return std::make_unique<FileReadStream<uint8_t, decltype(parse)>>(path.toStdString(), parse);
+        return std::make_unique<MmapReadStream>(path.toStdString());
     } catch (const std::exception& ex) {
         if (error) {
             *error = ex.what();
@@ -50,6 +47,19 @@ std::unique_ptr<ReadOnlyStream<uint8_t>> makeFileStream(const QString& path, QSt
     }
 }
 
+// variant is an index into the variant combo box: standard, URL-safe or MIME.
+std::unique_ptr<ReadOnlyStream<char>> makeEncoder(std::unique_ptr<ReadOnlyStream<uint8_t>> src, size_t bufferSize,
+                                                  int variant) {
+    switch (variant) {
+        case 1:
+            return std::make_unique<Base64UrlEncodeStream>(std::move(src), bufferSize);
+        case 2:
+            return std::make_unique<Base64MimeEncodeStream>(std::move(src), bufferSize);
+        default:
+            return std::make_unique<Base64EncodeStream>(std::move(src), bufferSize);
+    }
+}
+
 }  // namespace
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
@@ -111,6 +121,10 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     bufferSize_->setValue(3 * 1024);
     bufferSize_->setSuffix(" bytes");
 
+    // Variant
+    variant_ = new QComboBox(central);
+    variant_->addItems({"Standard (RFC 4648)", "URL-safe, no padding", "MIME (76-char lines)"});
+
     // Output
     outputText_ = new QPlainTextEdit(central);
     outputText_->setReadOnly(true);
@@ -166,6 +180,8 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     bufferLayout->setContentsMargins(0, 0, 0, 0);
     bufferLayout->addWidget(new QLabel("Input buffer size:"));
     bufferLayout->addWidget(bufferSize_);
+    bufferLayout->addWidget(new QLabel("Variant:"));
+    bufferLayout->addWidget(variant_);
     bufferLayout->addStretch(1);
     grid->addWidget(bufferRow, row++, 0, 1, 3);
 
@@ -291,19 +307,14 @@ QString MainWindow::encodePreview(size_t maxChars, bool* truncated) {
 
     auto start = std::chrono::steady_clock::now();
 
-    auto encoder = std::make_unique<Base64EncodeStream>(std::move(src), static_cast<size_t>(bufferSize_->value()));
-    std::string out;
-    out.reserve(std::min<size_t>(maxChars, 1024 * 1024));
-
-    while (!encoder->IsEndOfStream()) {
-        char c = encoder->Read();
-        if (out.size() < maxChars) {
-            out.push_back(c);
-        } else {
-            if (truncated) {
-                *truncated = true;
-            }
-            break;
+    auto encoder = makeEncoder(std::move(src), static_cast<size_t>(bufferSize_->value()), variant_->currentIndex());
+    // One extra char tells whether the preview was truncated.
+    std::string out(maxChars + 1, '\0');
+    out.resize(encoder->Read(std::span<char>(out)));
+    if (out.size() > maxChars) {
+        out.resize(maxChars);
+        if (truncated) {
+            *truncated = true;
         }
     }
 
@@ -357,18 +368,17 @@ bool MainWindow::encodeToFile(const QString& outPath, QString* error) {
     }
 
     try {
-        auto serialize = [](std::ostream& os, char c) {
-            os.put(c);
-        };
-
         auto start = std::chrono::steady_clock::now();
 
-        auto encoder = std::make_unique<Base64EncodeStream>(std::move(src), static_cast<size_t>(bufferSize_->value()));
-        auto writer = std::make_unique<FileWriteStream<char, decltype(serialize)>>(outPath.toStdString(), serialize);
+        auto encoder = makeEncoder(std::move(src), static_cast<size_t>(bufferSize_->value()), variant_->currentIndex());
+        auto writer = std::make_unique<FileWriteStream<char, RawSerialize<char>>>(outPath.toStdString(),
+                                                                                  RawSerialize<char>{});
 
-        while (!encoder->IsEndOfStream()) {
-            writer->Write(encoder->Read());
+        std::vector<char> buffer(64 * 1024);
+        while (size_t n = encoder->Read(std::span<char>(buffer))) {
+            writer->Write(std::span<const char>(buffer.data(), n));
         }
+        writer->Flush();
 
         auto end = std::chrono::steady_clock::now();
         const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -3,6 +3,7 @@
 #include <QMainWindow>
 
 class QButtonGroup;
+class QComboBox;
 class QLineEdit;
 class QPlainTextEdit;
 class QPushButton;
@@ -38,6 +39,7 @@ private:
     QSpinBox* randomMb_ = nullptr;
 
     QSpinBox* bufferSize_ = nullptr;
+    QComboBox* variant_ = nullptr;
 
     QPlainTextEdit* outputText_ = nullptr;
     QPushButton* encodeBtn_ = nullptr;
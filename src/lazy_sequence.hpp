@@ -1,10 +1,76 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
 
+#include "arena.hpp"
 #include "array_sequence.hpp"
 #include "cardinal.hpp"
+#include "segmented_sequence.hpp"
+#include "sequence_view.hpp"
+
+// How many generated items a LazySequence keeps. Full keeps all of them, Window(k) the last k (but never fewer
+// than a generator function's arity) and None only the item last returned, for forward-only consumers. Either
+// also keeps the block last returned by GetBlock. Requesting an evicted index throws std::out_of_range.
+class Memoization {
+public:
+    static Memoization Full() {
+        return Memoization(std::numeric_limits<size_t>::max());
+    }
+
+    static Memoization Window(size_t count) {
+        return Memoization(std::max<size_t>(count, 1));
+    }
+
+    static Memoization None() {
+        return Memoization(1);
+    }
+
+    bool IsFull() const {
+        return window_ == std::numeric_limits<size_t>::max();
+    }
+
+    size_t GetWindow() const {
+        return window_;
+    }
+
+private:
+    explicit Memoization(size_t window) : window_(window) {
+    }
+
+    size_t window_;
+};
+
+#ifdef LAB1_LAZY_STATS
+inline constexpr bool kLazySequenceStats = true;
+#else
+inline constexpr bool kLazySequenceStats = false;
+#endif
+
+// What a LazySequence holds and, when built with LAB1_LAZY_STATS (the CMake option of the same name), how much
+// work its generator did. Without it the counters stay zero and cost nothing.
+struct LazySequenceStats {
+    // Items generated so far, including evicted ones: GetMaterializedCount().
+    size_t materialized = 0;
+    size_t memoized = 0;
+    size_t memoBytes = 0;
+
+    size_t generatorCalls = 0;
+    // Items of a random-access sequence computed without memoizing them, see GetIndex.
+    size_t directItems = 0;
+    // Time in the generator, including the sources it reads from.
+    std::chrono::nanoseconds generatorTime{0};
+};
 
 template <typename T>
 class LazySequenceIterator : public IConstEnumerator<T> {
@@ -40,6 +106,11 @@ class LazySequence : public std::enable_shared_from_this<LazySequence<T>> {
     friend class LazySequence;
 
 private:
+    // Memoized items and the windows handed to generator functions are allocated from the default memory
+    // resource at construction, see ScopedDefaultResource in arena.hpp. Blocks of the memo never move, so
+    // references returned by GetIndex stay valid until the item is evicted.
+    using Storage = SegmentedSequence<T, ResourceAllocator<T>>;
+
     class IGenerator;
 
     class DefaultGenerator;
@@ -49,6 +120,10 @@ private:
     template <typename Func>
     class FunctionGenerator;
 
+    struct IndexTag {};
+    template <typename Func>
+    class IndexGenerator;
+
     struct SubSequenceTag {};
     class SubsequenceGenerator;
 
@@ -81,11 +156,39 @@ private:
     public:
         virtual ~IGenerator() = default;
 
-        virtual T GetNext() = 0;
-
+        // Returns std::nullopt at the end of the sequence, so running out is a branch rather than an exception.
         virtual std::optional<T> TryGetNext() = 0;
 
         virtual bool HasNext() const = 0;
+
+        // Writes up to out.size() next items and returns how many; 0 only when there is no next item.
+        virtual size_t GetNextBatch(std::span<T> out) {
+            size_t n = 0;
+            for (; n < out.size(); ++n) {
+                std::optional<T> item = TryGetNext();
+                if (!item) {
+                    break;
+                }
+                out[n] = std::move(*item);
+            }
+            return n;
+        }
+
+        // Whether At() works: the item at any index can be computed without generating the ones before it.
+        virtual bool IsRandomAccess() const {
+            return false;
+        }
+
+        // The item at index of the whole sequence, or std::nullopt past its end.
+        virtual std::optional<T> At(size_t index) const {
+            throw std::logic_error("Generator is not random-access");
+        }
+
+        virtual const char* GetName() const = 0;
+
+        // Calls DumpStats of the sequences this generator reads from.
+        virtual void DumpSources(std::ostream& os, size_t depth) const {
+        }
     };
 
     class DefaultGenerator : public IGenerator {
@@ -93,9 +196,9 @@ private:
         explicit DefaultGenerator(LazySequencePtr<T> seq) : seq_(std::move(seq)), it_(seq_->GetConstEnumerator()) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
             T res = it_->ConstDereference();
             it_->MoveNext();
@@ -106,12 +209,12 @@ private:
             return !it_->IsEnd();
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
-            }
+        const char* GetName() const override {
+            return "Copy";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq_->DumpStats(os, depth);
         }
 
     private:
@@ -124,82 +227,178 @@ private:
     public:
         SequenceGenerator() = default;
 
-        T GetNext() override {
-            throw std::out_of_range("GetNext: no next element");
+        std::optional<T> TryGetNext() override {
+            return std::nullopt;
         }
 
         bool HasNext() const override {
             return false;
         }
 
-        std::optional<T> TryGetNext() override {
+        bool IsRandomAccess() const override {
+            return true;
+        }
+
+        // Every item is memoized, so anything that gets here is past the end.
+        std::optional<T> At(size_t index) const override {
             return std::nullopt;
         }
+
+        const char* GetName() const override {
+            return "Array";
+        }
     };
 
     template <typename Func>
     class FunctionGenerator : public IGenerator {
     public:
         FunctionGenerator(LazySequence<T>* owner, Func func, size_t arity)
-            : owner_(owner), func_(std::move(func)), arity_(arity) {
+            : owner_(owner), func_(std::move(func)), arity_(arity), window_(std::make_shared<SequenceView<T>>()) {
         }
 
-        T GetNext() override {
-            SequencePtr<T> suf = owner_->items_->GetLast(arity_);
-            return func_(suf);
+        std::optional<T> TryGetNext() override {
+            history_.Clear();
+            AppendLastItems();
+            return Generate(history_.GetConstBegin());
         }
 
         bool HasNext() const override {
             return true;
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
+        // Items of a batch are not memoized yet, and the memo is not contiguous across its blocks, so the batch
+        // is built after a copy of the last arity_ memoized items, where the window of every item is contiguous.
+        size_t GetNextBatch(std::span<T> out) override {
+            history_.Clear();
+            history_.Reserve(arity_ + out.size());
+            AppendLastItems();
+            for (size_t i = 0; i < out.size(); ++i) {
+                history_.PushBack(Generate(history_.GetConstBegin() + i));
             }
+            std::copy_n(history_.GetConstBegin() + arity_, out.size(), out.begin());
+            return out.size();
+        }
+
+        const char* GetName() const override {
+            return "Function";
         }
 
     private:
         LazySequence<T>* owner_;
         Func func_;
         size_t arity_;
+        std::shared_ptr<SequenceView<T>> window_;
+        DynamicArray<T, ResourceAllocator<T>> history_;
+
+        void AppendLastItems() {
+            Storage& items = owner_->items_;
+            for (size_t i = items.GetLength() - arity_; i < items.GetLength(); ++i) {
+                history_.PushBack(items[i]);
+            }
+        }
+
+        // func_ sees the arity_ items from first on through a view, so generating an item allocates nothing.
+        T Generate(const T* first) {
+            window_->Reset(first, arity_);
+            T res = func_(window_);
+            if (window_.use_count() != 1) {
+                // func_ kept the window, which would dangle once history_ is reused.
+                window_->Detach();
+                window_ = std::make_shared<SequenceView<T>>();
+            }
+            return res;
+        }
+    };
+
+    template <typename Func>
+    class IndexGenerator : public IGenerator {
+    public:
+        explicit IndexGenerator(Func func) : func_(std::move(func)) {
+        }
+
+        std::optional<T> TryGetNext() override {
+            return func_(pos_++);
+        }
+
+        bool HasNext() const override {
+            return true;
+        }
+
+        size_t GetNextBatch(std::span<T> out) override {
+            for (size_t i = 0; i < out.size(); ++i) {
+                out[i] = func_(pos_ + i);
+            }
+            pos_ += out.size();
+            return out.size();
+        }
+
+        bool IsRandomAccess() const override {
+            return true;
+        }
+
+        std::optional<T> At(size_t index) const override {
+            return func_(index);
+        }
+
+        const char* GetName() const override {
+            return "FromFunction";
+        }
+
+    private:
+        Func func_;
+        size_t pos_ = 0;
     };
 
     class SubsequenceGenerator : public IGenerator {
     public:
         SubsequenceGenerator(LazySequencePtr<T> seq, size_t startIndex, size_t endIndex)
-            : seq_(std::move(seq)), it_(seq_->GetConstEnumerator()), startIndex_(startIndex), endIndex_(endIndex) {
-            for (size_t i = 0; i < startIndex; ++i) {
-                it_->MoveNext();
-            }
+            : seq_(std::move(seq)), pos_(startIndex), startIndex_(startIndex), endIndex_(endIndex) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
-            T res = it_->ConstDereference();
-            it_->MoveNext();
-            return res;
+            return seq_->GetIndex(pos_++);
         }
 
         bool HasNext() const override {
-            return it_->Index() != endIndex_ + 1;
+            return pos_ <= endIndex_ && seq_->HasItem(pos_);
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
+        size_t GetNextBatch(std::span<T> out) override {
+            if (pos_ > endIndex_) {
+                return 0;
+            }
+            const std::span<const T> block = seq_->GetBlock(pos_, std::min(out.size(), endIndex_ + 1 - pos_));
+            std::copy(block.begin(), block.end(), out.begin());
+            pos_ += block.size();
+            return block.size();
+        }
+
+        // The source must reach endIndex_, otherwise the length of the subsequence is not exact.
+        bool IsRandomAccess() const override {
+            return seq_->IsRandomAccess() && Cardinal(endIndex_) < seq_->GetLength();
+        }
+
+        std::optional<T> At(size_t index) const override {
+            if (index > endIndex_ - startIndex_) {
                 return std::nullopt;
             }
+            return seq_->Peek(startIndex_ + index);
+        }
+
+        const char* GetName() const override {
+            return "Subsequence";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq_->DumpStats(os, depth);
         }
 
     private:
         LazySequencePtr<T> seq_;
-        IConstEnumeratorPtr<T> it_;
+        size_t pos_;
         size_t startIndex_;
         size_t endIndex_;
     };
@@ -210,9 +409,9 @@ private:
             : seq_(std::move(seq)), it_(seq_->GetConstEnumerator()), startIndex_(startIndex), endIndex_(endIndex) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
             if (it_->Index() >= startIndex_) {
                 while (it_->Index() <= endIndex_) {
@@ -228,12 +427,20 @@ private:
             return !it_->IsEnd();
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
-            }
+        bool IsRandomAccess() const override {
+            return seq_->IsRandomAccess() && Cardinal(endIndex_) < seq_->GetLength();
+        }
+
+        std::optional<T> At(size_t index) const override {
+            return seq_->Peek(index < startIndex_ ? index : index + (endIndex_ - startIndex_ + 1));
+        }
+
+        const char* GetName() const override {
+            return "Skip";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq_->DumpStats(os, depth);
         }
 
     private:
@@ -249,9 +456,9 @@ private:
             : seq_(std::move(seq)), it_(seq_->GetConstEnumerator()), item_(item), added_(false) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
             if (!it_->IsEnd()) {
                 T res = it_->ConstDereference();
@@ -266,12 +473,12 @@ private:
             return !it_->IsEnd() || !added_;
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
-            }
+        const char* GetName() const override {
+            return "Append";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq_->DumpStats(os, depth);
         }
 
     private:
@@ -292,14 +499,14 @@ private:
               added_(false) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
             if (cur_ == index_) {
                 added_ = true;
                 ++cur_;
-                return std::move(item_);
+                return item_;
             }
             ++cur_;
             T res = it_->ConstDereference();
@@ -311,12 +518,23 @@ private:
             return !it_->IsEnd() || !added_;
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
+        bool IsRandomAccess() const override {
+            return seq_->IsRandomAccess();
+        }
+
+        std::optional<T> At(size_t index) const override {
+            if (index == index_) {
+                return item_;
             }
+            return seq_->Peek(index < index_ ? index : index - 1);
+        }
+
+        const char* GetName() const override {
+            return "InsertAt";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq_->DumpStats(os, depth);
         }
 
     private:
@@ -331,235 +549,309 @@ private:
     class ConcatGenerator : public IGenerator {
     public:
         ConcatGenerator(LazySequencePtr<T> seq1, LazySequencePtr<T> seq2)
-            : seq1_(std::move(seq1)),
-              it1_(seq1_->GetConstEnumerator()),
-              seq2_(std::move(seq2)),
-              it2_(seq2_->GetConstEnumerator()) {
+            : seq1_(std::move(seq1)), seq2_(std::move(seq2)) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
-            if (it1_->IsEnd()) {
-                T res = it2_->ConstDereference();
-                it2_->MoveNext();
-                return res;
+            if (seq1_->HasItem(pos1_)) {
+                return seq1_->GetIndex(pos1_++);
             }
-            T res = it1_->ConstDereference();
-            it1_->MoveNext();
-            return res;
+            return seq2_->GetIndex(pos2_++);
         }
 
         bool HasNext() const override {
-            return !it1_->IsEnd() || !it2_->IsEnd();
+            return seq1_->HasItem(pos1_) || seq2_->HasItem(pos2_);
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
+        size_t GetNextBatch(std::span<T> out) override {
+            std::span<const T> block = seq1_->GetBlock(pos1_, out.size());
+            if (!block.empty()) {
+                pos1_ += block.size();
+            } else {
+                block = seq2_->GetBlock(pos2_, out.size());
+                pos2_ += block.size();
+            }
+            std::copy(block.begin(), block.end(), out.begin());
+            return block.size();
+        }
+
+        bool IsRandomAccess() const override {
+            return seq1_->IsRandomAccess() && seq2_->IsRandomAccess();
+        }
+
+        // Random-access sequences have exact lengths, so the split point is known.
+        std::optional<T> At(size_t index) const override {
+            const Cardinal length1 = seq1_->GetLength();
+            if (length1.IsFinite() && index >= length1.GetFinite()) {
+                return seq2_->Peek(index - length1.GetFinite());
             }
+            return seq1_->Peek(index);
+        }
+
+        const char* GetName() const override {
+            return "Concat";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq1_->DumpStats(os, depth);
+            seq2_->DumpStats(os, depth);
         }
 
     private:
         LazySequencePtr<T> seq1_;
-        IConstEnumeratorPtr<T> it1_;
         LazySequencePtr<T> seq2_;
-        IConstEnumeratorPtr<T> it2_;
+        size_t pos1_ = 0;
+        size_t pos2_ = 0;
     };
 
     template <typename T2, typename Func>
     class MapGenerator : public IGenerator {
     public:
-        MapGenerator(LazySequencePtr<T2> seq, Func func)
-            : seq_(std::move(seq)), it_(seq_->GetConstEnumerator()), func_(std::move(func)) {
+        MapGenerator(LazySequencePtr<T2> seq, Func func) : seq_(std::move(seq)), func_(std::move(func)) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
-            T2 res = it_->ConstDereference();
-            it_->MoveNext();
-            return func_(res);
+            return func_(seq_->GetIndex(pos_++));
         }
 
         bool HasNext() const override {
-            return !it_->IsEnd();
+            return seq_->HasItem(pos_);
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
+        // A plain loop over the source block, which the compiler can inline func_ into and vectorize.
+        size_t GetNextBatch(std::span<T> out) override {
+            const std::span<const T2> block = seq_->GetBlock(pos_, out.size());
+            for (size_t i = 0; i < block.size(); ++i) {
+                out[i] = func_(block[i]);
+            }
+            pos_ += block.size();
+            return block.size();
+        }
+
+        bool IsRandomAccess() const override {
+            return seq_->IsRandomAccess();
+        }
+
+        std::optional<T> At(size_t index) const override {
+            std::optional<T2> item = seq_->Peek(index);
+            if (!item) {
                 return std::nullopt;
             }
+            return func_(*item);
+        }
+
+        const char* GetName() const override {
+            return "Map";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq_->DumpStats(os, depth);
         }
 
     private:
         LazySequencePtr<T2> seq_;
-        IConstEnumeratorPtr<T2> it_;
         Func func_;
+        size_t pos_ = 0;
     };
 
     template <typename T1, typename T2>
     class ZipGenerator : public IGenerator {
     public:
         ZipGenerator(LazySequencePtr<T1> seq1, LazySequencePtr<T2> seq2)
-            : seq1_(std::move(seq1)),
-              it1_(seq1_->GetConstEnumerator()),
-              seq2_(std::move(seq2)),
-              it2_(seq2_->GetConstEnumerator()) {
+            : seq1_(std::move(seq1)), seq2_(std::move(seq2)) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
-            T1 res1 = it1_->ConstDereference();
-            it1_->MoveNext();
-            T2 res2 = it2_->ConstDereference();
-            it2_->MoveNext();
+            T1 res1 = seq1_->GetIndex(pos_);
+            T2 res2 = seq2_->GetIndex(pos_);
+            ++pos_;
             return T{res1, res2};
         }
 
         bool HasNext() const override {
             // Zip ends as soon as any input ends.
-            return !it1_->IsEnd() && !it2_->IsEnd();
+            return seq1_->HasItem(pos_) && seq2_->HasItem(pos_);
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
+        // first stays valid: seq2_ only generates items of its own, and never of seq1_ since they are memoized.
+        size_t GetNextBatch(std::span<T> out) override {
+            const std::span<const T1> first = seq1_->GetBlock(pos_, out.size());
+            const std::span<const T2> second = seq2_->GetBlock(pos_, first.size());
+            for (size_t i = 0; i < second.size(); ++i) {
+                out[i] = T{first[i], second[i]};
             }
+            pos_ += second.size();
+            return second.size();
+        }
+
+        const char* GetName() const override {
+            return "Zip";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq1_->DumpStats(os, depth);
+            seq2_->DumpStats(os, depth);
         }
 
     private:
         LazySequencePtr<T1> seq1_;
-        IConstEnumeratorPtr<T1> it1_;
         LazySequencePtr<T2> seq2_;
-        IConstEnumeratorPtr<T2> it2_;
+        size_t pos_ = 0;
     };
 
     template <typename Func>
     class WhereGenerator : public IGenerator {
     public:
-        WhereGenerator(LazySequencePtr<T> seq, Func func)
-            : seq_(std::move(seq)), it_(seq_->GetConstEnumerator()), func_(std::move(func)) {
+        WhereGenerator(LazySequencePtr<T> seq, Func func) : seq_(std::move(seq)), func_(std::move(func)) {
         }
 
-        T GetNext() override {
+        std::optional<T> TryGetNext() override {
             if (!HasNext()) {
-                throw std::out_of_range("GetNext: no next element");
+                return std::nullopt;
             }
-            hasPrefetch_ = false;
-            return std::move(prefetch_.value());
+            matched_ = false;
+            return seq_->GetIndex(pos_++);
         }
 
+        // Stops at the next match without consuming it; matched_ keeps func_ from running on it twice.
         bool HasNext() const override {
-            if (hasPrefetch_) {
+            if (matched_) {
                 return true;
             }
-            while (!it_->IsEnd() && !func_(it_->ConstDereference())) {
-                it_->MoveNext();
-            }
-            if (it_->IsEnd()) {
-                return false;
+            while (seq_->HasItem(pos_)) {
+                if (func_(seq_->GetIndex(pos_))) {
+                    matched_ = true;
+                    return true;
+                }
+                ++pos_;
             }
-            prefetch_ = it_->ConstDereference();
-            it_->MoveNext();
-            hasPrefetch_ = true;
-            return true;
+            return false;
         }
 
-        std::optional<T> TryGetNext() override {
-            try {
-                return GetNext();
-            } catch (const std::exception& ex) {
-                return std::nullopt;
+        // Asks the source for no more items than there are free slots, so it never reads past the last match
+        // the caller needs.
+        size_t GetNextBatch(std::span<T> out) override {
+            size_t n = 0;
+            if (matched_ && !out.empty()) {
+                out[n++] = seq_->GetIndex(pos_++);
+                matched_ = false;
             }
+            while (n < out.size()) {
+                const std::span<const T> block = seq_->GetBlock(pos_, out.size() - n);
+                if (block.empty()) {
+                    break;
+                }
+                pos_ += block.size();
+                for (const T& item : block) {
+                    if (func_(item)) {
+                        out[n++] = item;
+                    }
+                }
+            }
+            return n;
+        }
+
+        const char* GetName() const override {
+            return "Where";
+        }
+
+        void DumpSources(std::ostream& os, size_t depth) const override {
+            seq_->DumpStats(os, depth);
         }
 
     private:
         LazySequencePtr<T> seq_;
-        IConstEnumeratorPtr<T> it_;
         Func func_;
 
-        mutable bool hasPrefetch_ = false;
-        mutable std::optional<T> prefetch_;
+        mutable size_t pos_ = 0;
+        mutable bool matched_ = false;
     };
 
 public:
     virtual ~LazySequence() = default;
 
     LazySequence()
-        : items_(std::make_unique<ArraySequence<T>>()), generator_(std::make_unique<SequenceGenerator>()), length_(0) {
+        : length_(0), generator_(std::make_unique<SequenceGenerator>()) {
     }
 
     LazySequence(const T* items, int count)
         : length_(count),
-          items_(std::make_unique<ArraySequence<T>>(items, count)),
+          items_(items, count),
           generator_(std::make_unique<SequenceGenerator>()) {
     }
 
     LazySequence(SequencePtr<T> seq)
         : length_(seq->GetLength()),
-          items_(std::make_unique<ArraySequence<T>>(*seq)),
+          items_(*seq),
+          generator_(std::make_unique<SequenceGenerator>()) {
+    }
+
+    // Adopts items that are already materialized, without copying them.
+    explicit LazySequence(SegmentedSequence<T, ResourceAllocator<T>> items)
+        : length_(items.GetLength()),
+          items_(std::move(items)),
           generator_(std::make_unique<SequenceGenerator>()) {
     }
 
     LazySequence(LazySequencePtr<T> seq)
         : length_(seq->GetLength()),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<DefaultGenerator>(std::move(seq))) {
     }
 
     template <typename Func>
     LazySequence(Func func, SequencePtr<T> seq, size_t arity)
         : length_(Cardinals::N0),
-          items_(std::make_unique<ArraySequence<T>>(std::move(seq))),
-          generator_(std::make_unique<FunctionGenerator<Func>>(this, std::move(func), arity)) {
-        if (items_->GetLength() < arity) {
+          items_(std::move(seq)),
+          generator_(std::make_unique<FunctionGenerator<Func>>(this, std::move(func), arity)),
+          arity_(arity) {
+        if (items_.GetLength() < arity) {
             throw std::runtime_error("Given less starting elements than arity");
         }
     }
 
+    // FromFunction
+    template <typename Func>
+    LazySequence(Func func, IndexTag)
+        : length_(Cardinals::N0),
+          generator_(std::make_unique<IndexGenerator<Func>>(std::move(func))) {
+    }
+
     // Subsequence
     LazySequence(LazySequencePtr<T> seq, size_t startIndex, size_t endIndex, SubSequenceTag)
         : length_(endIndex - startIndex + 1),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<SubsequenceGenerator>(std::move(seq), startIndex, endIndex)) {
     }
 
     // Skip
     LazySequence(LazySequencePtr<T> seq, size_t startIndex, size_t endIndex, SkipTag)
         : length_(seq->length_ - (endIndex - startIndex + 1)),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<SkipGenerator>(std::move(seq), startIndex, endIndex)) {
     }
 
     // Append
     LazySequence(LazySequencePtr<T> seq, const T& item, AppendTag)
         : length_(seq->length_ + 1),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<AppendGenerator>(std::move(seq), item)) {
     }
 
     // InsertAt
     LazySequence(LazySequencePtr<T> seq, const T& item, size_t index, InsertTag)
         : length_(seq->length_ + 1),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<InsertGenerator>(std::move(seq), item, index)) {
     }
 
     // Concat
     LazySequence(LazySequencePtr<T> seq1, LazySequencePtr<T> seq2, ConcatTag)
         : length_(seq1->GetLength() + seq2->GetLength()),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<ConcatGenerator>(std::move(seq1), std::move(seq2))) {
     }
 
@@ -567,7 +859,6 @@ public:
     template <typename T2, typename Func>
     LazySequence(LazySequencePtr<T2> seq, Func func, MapTag)
         : length_(seq->GetLength()),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<MapGenerator<T2, Func>>(std::move(seq), std::move(func))) {
     }
 
@@ -575,7 +866,6 @@ public:
     template <typename Func>
     LazySequence(LazySequencePtr<T> seq, Func func, WhereTag)
         : length_(seq->GetLength()),  // Upper bound; exact length is unknown without full evaluation.
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<WhereGenerator<Func>>(std::move(seq), std::move(func))) {
     }
 
@@ -583,29 +873,70 @@ public:
     template <typename T1, typename T2>
     LazySequence(LazySequencePtr<T1> seq1, LazySequencePtr<T2> seq2, ZipTag)
         : length_(std::min(seq1->GetLength(), seq2->GetLength())),
-          items_(std::make_unique<ArraySequence<T>>()),
           generator_(std::make_unique<ZipGenerator<T1, T2>>(std::move(seq1), std::move(seq2))) {
     }
 
 public:
+    // The infinite sequence func(0), func(1), ... Its items, and those of Map, GetSubsequence, Skip, InsertAt and
+    // Concat chains over it, are random-access.
+    template <typename Func>
+    static LazySequencePtr<T> FromFunction(Func func) {
+        return std::make_shared<LazySequence<T>>(std::move(func), IndexTag{});
+    }
+
     const T& GetFirst() const {
         return GetIndex(0);
     }
 
     const T& GetLast() const {
-        while (generator_->HasNext()) {
-            items_->Append(generator_->GetNext());
-        }
-        return items_->GetLast();
+        Materialize(std::numeric_limits<size_t>::max());
+        return items_.GetLast();
     }
 
+    // For a random-access sequence an index far past the memo is computed directly, without generating or
+    // memoizing the items before it. Its reference then stays valid until kDirectSlots more items are computed
+    // directly, so a few of them can be held at once.
     const T& GetIndex(size_t index) const {
-        if (index >= items_->GetLength()) {
-            for (size_t i = items_->GetLength(); i <= index; ++i) {
-                items_->Append(generator_->GetNext());
-            }
+        CheckNotEvicted(index);
+        if (IsDirect(index)) {
+            return GetDirect(index);
         }
-        return items_->Get(index);
+        Materialize(index + 1, index);
+        if (GetMaterializedCount() <= index) {
+            throw std::out_of_range("GetNext: no next element");
+        }
+        return items_[index - evicted_];
+    }
+
+    // Memoizes items up to startIndex + count and returns the ones from startIndex on: at least one unless the
+    // sequence ends before startIndex, at most count, never past the end of a memo block and, under a bounded
+    // memoization policy, at most its window or one batch, whichever is larger. The span is valid until the
+    // sequence generates again; like GetIndex, a random-access sequence computes a block far from its memo
+    // directly.
+    std::span<const T> GetBlock(size_t startIndex, size_t count) const {
+        CheckNotEvicted(startIndex);
+        if (IsDirect(startIndex)) {
+            return ComputeDirect(startIndex, std::min(count, kBatchSize));
+        }
+        if (!memo_.IsFull()) {
+            count = std::min(count, std::max({memo_.GetWindow(), arity_, kBatchSize}));
+        }
+        Materialize(startIndex + count, startIndex);
+        const size_t end = std::min(startIndex + count, GetMaterializedCount());
+        if (end <= startIndex) {
+            return {};
+        }
+        const std::span<const T> chunk = std::as_const(items_).GetChunk(startIndex - evicted_);
+        return chunk.first(std::min(chunk.size(), end - startIndex));
+    }
+
+    // Applies from the next generated item on; items evicted before stay unavailable.
+    void SetMemoization(Memoization memo) {
+        memo_ = memo;
+    }
+
+    Memoization GetMemoization() const {
+        return memo_;
     }
 
     LazySequencePtr<T> GetSubsequence(size_t startIndex, size_t endIndex) {
@@ -626,14 +957,29 @@ public:
         return length_;
     }
 
+    // Items generated so far, including evicted ones.
     size_t GetMaterializedCount() const {
-        return items_->GetLength();
+        return evicted_ + items_.GetLength();
     }
 
     bool HasNext() const {
         return generator_->HasNext();
     }
 
+    // Whether any item can be computed in O(1) from its index, see GetIndex.
+    bool IsRandomAccess() const {
+        return generator_->IsRandomAccess();
+    }
+
+    // The item at index of a random-access sequence from the memo or the generator, or std::nullopt past the end.
+    // Nothing is memoized, so several threads may peek at once as long as nobody else uses the sequence.
+    std::optional<T> Peek(size_t index) const {
+        if (index >= evicted_ && index < GetMaterializedCount()) {
+            return items_[index - evicted_];
+        }
+        return generator_->At(index);
+    }
+
     LazySequencePtr<T> Append(const T& item) {
         return std::make_shared<LazySequence<T>>(this->shared_from_this(), item, AppendTag{});
     }
@@ -663,8 +1009,15 @@ public:
     template <typename T2, typename Func>
     auto Reduce(const T2& start, Func func) {
         T2 res = start;
-        for (auto it = GetConstEnumerator(); !it->IsEnd(); it->MoveNext()) {
-            res = func(res, it->ConstDereference());
+        for (size_t pos = 0;;) {
+            const std::span<const T> block = GetBlock(pos, kBatchSize);
+            if (block.empty()) {
+                break;
+            }
+            for (const T& item : block) {
+                res = func(res, item);
+            }
+            pos += block.size();
         }
         return res;
     }
@@ -685,8 +1038,239 @@ public:
         return std::make_shared<LazySequenceIterator<T>>(this->shared_from_this());
     }
 
+    // Input iterator that reads a GetBlock at a time and then walks it as a pointer, so the sequence is a
+    // std::ranges::input_range. It ends where the sequence does, compared with std::default_sentinel, and is
+    // invalidated like a GetBlock span. The sequence must outlive it.
+    class Iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        Iterator() = default;
+
+        const T& operator*() const {
+            return *it_;
+        }
+
+        Iterator& operator++() {
+            if (++it_ == end_) {
+                Load();
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return it_ == end_;
+        }
+
+    private:
+        friend class LazySequence;
+
+        const LazySequence* seq_ = nullptr;
+        const T* it_ = nullptr;
+        const T* end_ = nullptr;
+        // Index of the first item after [it_, end_).
+        size_t next_ = 0;
+
+        explicit Iterator(const LazySequence* seq) : seq_(seq) {
+            Load();
+        }
+
+        void Load() {
+            const std::span<const T> block = seq_->GetBlock(next_, kBatchSize);
+            it_ = block.data();
+            end_ = block.data() + block.size();
+            next_ += block.size();
+        }
+    };
+
+    Iterator begin() const {
+        return Iterator(this);
+    }
+
+    std::default_sentinel_t end() const {
+        return std::default_sentinel;
+    }
+
+    LazySequenceStats GetStats() const {
+        LazySequenceStats stats;
+        stats.materialized = GetMaterializedCount();
+        stats.memoized = items_.GetLength();
+        stats.memoBytes = items_.GetCapacity() * sizeof(T);
+#ifdef LAB1_LAZY_STATS
+        stats.generatorCalls = counters_.generatorCalls;
+        stats.directItems = counters_.directItems;
+        stats.generatorTime = counters_.generatorTime;
+#endif
+        return stats;
+    }
+
+    // Prints the GetStats() of this sequence and, indented below it, of the sequences it reads from. A source
+    // shared by several operators is printed under each of them.
+    void DumpStats(std::ostream& os) const {
+        DumpStats(os, 0);
+    }
+
 private:
     const Cardinal length_;
-    const std::unique_ptr<Sequence<T>> items_;
+    mutable Storage items_;
     const std::unique_ptr<IGenerator> generator_;
+    const size_t arity_ = 0;
+    Memoization memo_ = Memoization::Full();
+    mutable size_t evicted_ = 0;
+    mutable DynamicArray<T, ResourceAllocator<T>> batch_;
+    mutable Storage direct_;
+    mutable size_t directStart_ = 0;
+    // The last items GetIndex computed directly, overwritten round-robin.
+    mutable DynamicArray<T, ResourceAllocator<T>> directSlots_;
+    mutable size_t nextDirectSlot_ = 0;
+#ifdef LAB1_LAZY_STATS
+    struct Counters {
+        size_t generatorCalls = 0;
+        size_t directItems = 0;
+        std::chrono::nanoseconds generatorTime{0};
+    };
+    mutable Counters counters_;
+#endif
+
+    // Items per GetNextBatch call: a few KiB, so a batch stays in L1 between the generator and the memo.
+    static constexpr size_t kBatchSize = std::max<size_t>(16, 4096 / sizeof(T));
+
+    // Directly computed items that GetIndex keeps alive at once.
+    static constexpr size_t kDirectSlots = 16;
+
+    // Whether a consumer that has read items [0, index) in order can read one more.
+    bool HasItem(size_t index) const {
+        return Cardinal(index) != length_ && (index < GetMaterializedCount() || generator_->HasNext());
+    }
+
+    void DumpStats(std::ostream& os, size_t depth) const {
+        const LazySequenceStats stats = GetStats();
+        os << std::string(2 * depth, ' ') << generator_->GetName() << ": " << stats.materialized << " materialized, "
+           << stats.memoized << " memoized (" << stats.memoBytes << " bytes)";
+        if constexpr (kLazySequenceStats) {
+            os << ", " << stats.generatorCalls << " generator calls, " << stats.directItems << " computed directly, "
+               << std::chrono::duration<double, std::milli>(stats.generatorTime).count() << " ms";
+        }
+        os << "\n";
+        generator_->DumpSources(os, depth + 1);
+    }
+
+    // Without LAB1_LAZY_STATS both compile to nothing.
+    static std::chrono::steady_clock::time_point StartGeneratorCall() {
+#ifdef LAB1_LAZY_STATS
+        return std::chrono::steady_clock::now();
+#else
+        return {};
+#endif
+    }
+
+    void EndGeneratorCall([[maybe_unused]] std::chrono::steady_clock::time_point started) const {
+#ifdef LAB1_LAZY_STATS
+        ++counters_.generatorCalls;
+        counters_.generatorTime += std::chrono::steady_clock::now() - started;
+#endif
+    }
+
+    // Whether index, which is not evicted, is better computed by the random-access generator than generated in
+    // order.
+    bool IsDirect(size_t index) const {
+        return index >= GetMaterializedCount() + kBatchSize && IsRandomAccess();
+    }
+
+    // Computes the item at index into the next of directSlots_.
+    const T& GetDirect(size_t index) const {
+        std::optional<T> item = generator_->At(index);
+        if (!item) {
+            throw std::out_of_range("GetIndex: index is out of range");
+        }
+#ifdef LAB1_LAZY_STATS
+        ++counters_.directItems;
+#endif
+        const size_t slot = nextDirectSlot_;
+        nextDirectSlot_ = (slot + 1) % kDirectSlots;
+        if (slot == directSlots_.GetSize()) {
+            directSlots_.Reserve(kDirectSlots);
+            directSlots_.PushBack(std::move(*item));
+        } else {
+            directSlots_[slot] = std::move(*item);
+        }
+        return directSlots_[slot];
+    }
+
+    // Computes up to count items from startIndex on into direct_, stopping at the end of the sequence. The memo
+    // is left untouched.
+    std::span<const T> ComputeDirect(size_t startIndex, size_t count) const {
+        if (directStart_ != startIndex || direct_.GetLength() < count) {
+            direct_.Clear();
+            directStart_ = startIndex;
+            for (size_t i = 0; i < count; ++i) {
+                std::optional<T> item = generator_->At(startIndex + i);
+                if (!item) {
+                    break;
+                }
+                direct_.Append(*item);
+            }
+#ifdef LAB1_LAZY_STATS
+            counters_.directItems += direct_.GetLength();
+#endif
+        }
+        return direct_.GetChunk(0).first(std::min(count, direct_.GetLength()));
+    }
+
+    void CheckNotEvicted(size_t index) const {
+        if (index < evicted_) {
+            throw std::out_of_range("GetIndex: item " + std::to_string(index) +
+                                    " was evicted by the memoization policy");
+        }
+    }
+
+    // Generates items in batches until count of them are materialized or the generator ends. Items from keepFrom
+    // on are not evicted, so the caller can return them.
+    void Materialize(size_t count, size_t keepFrom = std::numeric_limits<size_t>::max()) const {
+        while (GetMaterializedCount() < count) {
+            if constexpr (std::is_default_constructible_v<T>) {
+                if (batch_.GetSize() == 0) {
+                    batch_.Resize(kBatchSize);
+                }
+                const size_t want = std::min(kBatchSize, count - GetMaterializedCount());
+                const auto started = StartGeneratorCall();
+                const size_t n = generator_->GetNextBatch(std::span<T>(batch_.GetBegin(), want));
+                EndGeneratorCall(started);
+                if (n == 0) {
+                    return;
+                }
+                items_.AppendRange(std::span<const T>(batch_.GetConstBegin(), n));
+            } else {
+                const auto started = StartGeneratorCall();
+                std::optional<T> item = generator_->TryGetNext();
+                EndGeneratorCall(started);
+                if (!item) {
+                    return;
+                }
+                items_.Append(*item);
+            }
+            Evict(keepFrom);
+        }
+    }
+
+    // Evicts in batches of at least the window size, so a bounded memo costs O(1) amortized per item and its
+    // storage never grows past twice the window plus the block requested last, itself at most a batch or a window.
+    void Evict(size_t keepFrom) const {
+        if (memo_.IsFull()) {
+            return;
+        }
+        const size_t keep = std::max(memo_.GetWindow(), arity_);
+        const size_t size = items_.GetLength();
+        if (size >= 2 * keep && keepFrom > evicted_) {
+            const size_t count = std::min(size - keep, keepFrom - evicted_);
+            items_.RemoveRange(0, count - 1);
+            evicted_ += count;
+        }
+    }
 };
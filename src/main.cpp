@@ -1,24 +1,55 @@
 #include <iostream>
 #include <random>
+#include <vector>
 
 #include "array_sequence.hpp"
+#include "base64_decode_stream.hpp"
 #include "base64_encode_stream.hpp"
 #include "lazy_sequence.hpp"
+#include "mmap_read_stream.hpp"
+#include "parallel_base64_encoder.hpp"
 #include "read_stream.hpp"
 #include "write_stream.hpp"
 
+constexpr size_t kBufferSize = 64 * 1024;
+
+template <typename Variant = Base64Standard>
 void Encode(std::unique_ptr<ReadOnlyStream<uint8_t>> src, std::unique_ptr<WriteOnlyStream<char>> out) {
-    auto encoder = std::make_unique<Base64EncodeStream>(std::move(src));
-    while (!encoder->IsEndOfStream()) {
-        out->Write(encoder->Read());
+    auto encoder = std::make_unique<BasicBase64EncodeStream<Variant>>(std::move(src), kBufferSize);
+    std::vector<char> buffer(kBufferSize);
+    while (size_t n = encoder->Read(std::span<char>(buffer))) {
+        out->Write(std::span<const char>(buffer.data(), n));
+    }
+    out->Flush();
+}
+
+template <typename Variant = Base64Standard>
+void Decode(std::unique_ptr<ReadOnlyStream<char>> src, std::unique_ptr<WriteOnlyStream<uint8_t>> out,
+            Base64DecodeMode mode) {
+    auto decoder = std::make_unique<BasicBase64DecodeStream<Variant>>(std::move(src), kBufferSize, mode);
+    std::vector<uint8_t> buffer(kBufferSize);
+    while (size_t n = decoder->Read(std::span<uint8_t>(buffer))) {
+        out->Write(std::span<const uint8_t>(buffer.data(), n));
     }
+    out->Flush();
+}
+
+bool HasFlag(int argc, char* argv[], int first, const std::string& flag) {
+    for (int i = first; i < argc; ++i) {
+        if (argv[i] == flag) {
+            return true;
+        }
+    }
+    return false;
 }
 
 int main(int argc, char* argv[]) {
     if (argc < 3) {
         std::cout << "Usage:\n";
-        std::cout << "1) Encode file: " << argv[0] << " input_file output_file\n";
+        std::cout << "1) Encode file: " << argv[0] << " input_file output_file [--url | --mime]\n";
         std::cout << "2) Generate large test: " << argv[0] << " gen output_file size_in_bytes\n";
+        std::cout << "3) Encode file on several threads: " << argv[0] << " parallel input_file output_file [threads]\n";
+        std::cout << "4) Decode file: " << argv[0] << " decode input_file output_file [--lenient] [--url | --mime]\n";
         return 1;
     }
 
@@ -26,33 +57,69 @@ int main(int argc, char* argv[]) {
 
     std::string mode = argv[1];
 
-    auto parse = [](std::istream& is) -> uint8_t {
-        return is.get();
-    };
-
-    auto serialize = [](std::ostream& os, char c) {
-        os.put(c);
-    };
+    using Writer = FileWriteStream<char, RawSerialize<char>>;
 
     if (mode == "gen") {
         std::string outPath = argv[2];
         size_t size = std::stoull(argv[3]);
 
-        auto gen = std::make_shared<LazySequence<uint8_t>>(
-                       [&rng](SequencePtr<uint8_t>) {
-                           return rng() % 127;
-                       },
-                       std::make_shared<ArraySequence<uint8_t>>(), 0)
-                       ->GetSubsequence(0, size - 1);
+        // Both sequences are read once front to back, so neither keeps what it generated.
+        auto random = std::make_shared<LazySequence<uint8_t>>(
+            [&rng](SequencePtr<uint8_t>) {
+                return rng() % 127;
+            },
+            std::make_shared<ArraySequence<uint8_t>>(), 0);
+        random->SetMemoization(Memoization::None());
+        auto gen = random->GetSubsequence(0, size - 1);
+        gen->SetMemoization(Memoization::None());
 
         Encode(std::make_unique<LazySequenceReadStream<uint8_t>>(std::move(gen)),
-               std::make_unique<FileWriteStream<char, decltype(serialize)>>(outPath, serialize));
+               std::make_unique<Writer>(outPath, RawSerialize<char>{}, kBufferSize));
+    } else if (mode == "parallel") {
+        if (argc < 4) {
+            std::cout << "parallel mode needs input_file and output_file\n";
+            return 1;
+        }
+        const size_t threads = argc > 4 ? std::stoull(argv[4]) : std::thread::hardware_concurrency();
+        ThreadPool pool(threads);
+        MmapReadStream src(argv[2]);
+        Writer out(argv[3], RawSerialize<char>{}, kBufferSize);
+        ParallelBase64Encoder(pool).Encode(src, out);
+    } else if (mode == "decode") {
+        if (argc < 4) {
+            std::cout << "decode mode needs input_file and output_file\n";
+            return 1;
+        }
+        const auto decodeMode = HasFlag(argc, argv, 4, "--lenient") ? Base64DecodeMode::Lenient
+                                                                      : Base64DecodeMode::Strict;
+        try {
+            auto src = std::make_unique<BasicMmapReadStream<char>>(argv[2]);
+            auto out = std::make_unique<FileWriteStream<uint8_t, RawSerialize<uint8_t>>>(
+                argv[3], RawSerialize<uint8_t>{}, kBufferSize);
+            if (HasFlag(argc, argv, 4, "--url")) {
+                Decode<Base64Url>(std::move(src), std::move(out), decodeMode);
+            } else if (HasFlag(argc, argv, 4, "--mime")) {
+                Decode<Base64Mime>(std::move(src), std::move(out), decodeMode);
+            } else {
+                Decode(std::move(src), std::move(out), decodeMode);
+            }
+        } catch (const std::exception& ex) {
+            std::cout << "Cannot decode: " << ex.what() << "\n";
+            return 1;
+        }
     } else {
         std::string inPath = argv[1];
         std::string outPath = argv[2];
 
-        Encode(std::make_unique<FileReadStream<uint8_t, decltype(parse)>>(inPath, parse),
-               std::make_unique<FileWriteStream<char, decltype(serialize)>>(outPath, serialize));
+        auto src = std::make_unique<MmapReadStream>(inPath);
+        auto out = std::make_unique<Writer>(outPath, RawSerialize<char>{}, kBufferSize);
+        if (HasFlag(argc, argv, 3, "--url")) {
+            Encode<Base64Url>(std::move(src), std::move(out));
+        } else if (HasFlag(argc, argv, 3, "--mime")) {
+            Encode<Base64Mime>(std::move(src), std::move(out));
+        } else {
+            Encode(std::move(src), std::move(out));
+        }
     }
     std::cout << "Done.\n";
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "stream.hpp"
+
+// A read-only stream over a memory-mapped file of bytes or chars. Reads are served straight from the
+// mapping and ReadView() hands out zero-copy spans of it, so consumers never pay for read() copies.
+template <typename T>
+class BasicMmapReadStream final : public ReadOnlyStream<T> {
+    static_assert(sizeof(T) == 1, "BasicMmapReadStream maps files of bytes");
+
+public:
+    using ReadOnlyStream<T>::Read;
+
+    explicit BasicMmapReadStream(const std::string& file) {
+        const int fd = ::open(file.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file");
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat file");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ != 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (addr == MAP_FAILED) {
+                throw std::runtime_error("Cannot map file");
+            }
+            // Only a hint; failure is harmless.
+            ::madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const T*>(addr);
+        } else {
+            ::close(fd);
+        }
+    }
+
+    BasicMmapReadStream(const BasicMmapReadStream&) = delete;
+    BasicMmapReadStream& operator=(const BasicMmapReadStream&) = delete;
+
+    ~BasicMmapReadStream() override {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<T*>(data_), size_);
+        }
+    }
+
+    bool IsEndOfStream() const override {
+        return pos_ >= size_;
+    }
+
+    T Read() override {
+        if (IsEndOfStream()) {
+            throw std::runtime_error("End of stream");
+        }
+        return data_[pos_++];
+    }
+
+    size_t Read(std::span<T> out) override {
+        const std::span<const T> view = ReadView(out.size());
+        if (!view.empty()) {
+            std::memcpy(out.data(), view.data(), view.size());
+        }
+        return view.size();
+    }
+
+    size_t GetPosition() const override {
+        return pos_;
+    }
+
+    bool IsCanSeek() const override {
+        return true;
+    }
+
+    size_t Seek(size_t index) override {
+        if (index > size_) {
+            throw std::out_of_range("index is greater than length");
+        }
+        pos_ = index;
+        return pos_;
+    }
+
+    bool IsCanGoBack() const override {
+        return true;
+    }
+
+    bool IsCanView() const override {
+        return true;
+    }
+
+    std::span<const T> ReadView(size_t maxCount) override {
+        const size_t n = std::min(maxCount, size_ - pos_);
+        const std::span<const T> view(data_ + pos_, n);
+        pos_ += n;
+        return view;
+    }
+
+    // The whole mapped file, independent of the current position.
+    std::span<const T> GetView() const {
+        return {data_, size_};
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+};
+
+using MmapReadStream = BasicMmapReadStream<uint8_t>;
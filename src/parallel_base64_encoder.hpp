@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "base64_kernel.hpp"
+#include "stream.hpp"
+#include "thread_pool.hpp"
+
+// Base64 of 3-byte aligned chunks is independent, so the input is cut into chunks of whole triplets
+// that are encoded concurrently. Chunk i always lands at output offset i * chunkBytes / 3 * 4, which
+// makes the result byte-identical to Base64EncodeStream without any concatenation step.
+class ParallelBase64Encoder {
+public:
+    static constexpr size_t kDefaultChunkBytes = 3 * 256 * 1024;
+
+    explicit ParallelBase64Encoder(ThreadPool& pool, size_t chunkBytes = kDefaultChunkBytes,
+                                   Base64Kernel kernel = Base64BestKernel())
+        : pool_(pool), chunkBytes_(std::max<size_t>(1, chunkBytes / 3) * 3), kernel_(kernel) {
+    }
+
+    // Encodes the whole input with padding; out must hold Base64EncodedLength(in.size()) chars.
+    void Encode(std::span<const uint8_t> in, std::span<char> out) {
+        if (out.size() < Base64EncodedLength(in.size())) {
+            throw std::out_of_range("Output buffer is too small");
+        }
+        const size_t chunks = (in.size() + chunkBytes_ - 1) / chunkBytes_;
+        pool_.ParallelFor(chunks, [&](size_t i) {
+            const size_t begin = i * chunkBytes_;
+            const size_t size = std::min(chunkBytes_, in.size() - begin);
+            char* dst = out.data() + begin / 3 * 4;
+            const size_t done = Base64EncodeTriplets(kernel_, in.data() + begin, size, dst);
+            if (done != size) {
+                // Only the last chunk can end in a partial triplet.
+                Base64EncodeTail(in.data() + begin + done, size - done, dst + done / 3 * 4);
+            }
+        });
+    }
+
+    // Encodes the rest of src into out, one window of chunks per pool round. Sources that support
+    // views (e.g. MmapReadStream) are encoded in place. Returns the number of chars written.
+    size_t Encode(ReadOnlyStream<uint8_t>& src, WriteOnlyStream<char>& out) {
+        const size_t window = chunkBytes_ * pool_.GetThreadCount() * 2;
+        std::vector<uint8_t> in;
+        std::vector<char> encoded(Base64EncodedLength(window));
+        size_t written = 0;
+        while (!src.IsEndOfStream()) {
+            std::span<const uint8_t> block;
+            if (src.IsCanView()) {
+                block = src.ReadView(window);
+            } else {
+                in.resize(window);
+                in.resize(src.Read(std::span<uint8_t>(in)));
+                block = in;
+            }
+            if (block.empty()) {
+                break;
+            }
+            // Windows hold whole triplets, so padding can only appear in the last one.
+            Encode(block, encoded);
+            const size_t n = Base64EncodedLength(block.size());
+            out.Write(std::span<const char>(encoded.data(), n));
+            written += n;
+        }
+        out.Flush();
+        return written;
+    }
+
+private:
+    ThreadPool& pool_;
+    const size_t chunkBytes_;
+    const Base64Kernel kernel_;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arena.hpp"
+#include "dynamic_array.hpp"
+#include "lazy_sequence.hpp"
+#include "segmented_sequence.hpp"
+#include "thread_pool.hpp"
+
+// Data-parallel operations over finite random-access LazySequences, e.g. array-backed ones and Map or
+// GetSubsequence chains over them. The index range is cut into chunks of grain items that the pool's threads
+// claim one at a time, so chunks that take longer than others balance out. Items are read with Peek, so the
+// sequence must not be used by anyone else meanwhile, and every function passed in is called from several
+// threads at once.
+
+constexpr size_t kDefaultParallelGrain = 1 << 16;
+
+namespace parallel_sequence_detail {
+
+template <typename T>
+size_t CheckedLength(const LazySequence<T>& seq) {
+    if (!seq.GetLength().IsFinite() || !seq.IsRandomAccess()) {
+        throw std::logic_error("Parallel operations need a finite random-access sequence");
+    }
+    return seq.GetLength().GetFinite();
+}
+
+}  // namespace parallel_sequence_detail
+
+// op must be associative with identity as its identity element, and take (T2, T) as well as (T2, T2): every
+// chunk is folded from identity and the chunk results are combined in order.
+template <typename T, typename T2, typename Op>
+T2 ParallelReduce(ThreadPool& pool, const LazySequencePtr<T>& seq, const T2& identity, Op op,
+                  size_t grain = kDefaultParallelGrain) {
+    const size_t n = parallel_sequence_detail::CheckedLength(*seq);
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (n + grain - 1) / grain;
+    std::vector<T2> partials(chunks, identity);
+    pool.ParallelFor(chunks, [&](size_t chunk) {
+        const size_t end = std::min(n, (chunk + 1) * grain);
+        T2 res = identity;
+        for (size_t i = chunk * grain; i < end; ++i) {
+            res = op(std::move(res), *seq->Peek(i));
+        }
+        partials[chunk] = std::move(res);
+    });
+    T2 res = identity;
+    for (T2& partial : partials) {
+        res = op(std::move(res), std::move(partial));
+    }
+    return res;
+}
+
+// Materializes seq->Map(func) into an array-backed sequence.
+template <typename T, typename Func>
+auto ParallelMap(ThreadPool& pool, const LazySequencePtr<T>& seq, Func func, size_t grain = kDefaultParallelGrain) {
+    using T2 = std::invoke_result_t<Func&, const T&>;
+    const size_t n = parallel_sequence_detail::CheckedLength(*seq);
+    grain = std::max<size_t>(grain, 1);
+    SegmentedSequence<T2, ResourceAllocator<T2>> items;
+    items.Resize(n);
+    pool.ParallelFor((n + grain - 1) / grain, [&](size_t chunk) {
+        const size_t end = std::min(n, (chunk + 1) * grain);
+        for (size_t i = chunk * grain; i < end;) {
+            const std::span<T2> out = items.GetChunk(i);
+            for (size_t j = 0; j < out.size() && i < end; ++j) {
+                out[j] = func(*seq->Peek(i++));
+            }
+        }
+    });
+    return std::make_shared<LazySequence<T2>>(std::move(items));
+}
+
+// Materializes seq->Where(func) into an array-backed sequence, keeping the order. Each chunk collects its
+// matches, then the chunks are copied to offsets given by a prefix sum of their sizes.
+template <typename T, typename Func>
+LazySequencePtr<T> ParallelWhere(ThreadPool& pool, const LazySequencePtr<T>& seq, Func func,
+                                 size_t grain = kDefaultParallelGrain) {
+    const size_t n = parallel_sequence_detail::CheckedLength(*seq);
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (n + grain - 1) / grain;
+    std::vector<DynamicArray<T>> matches(chunks);
+    pool.ParallelFor(chunks, [&](size_t chunk) {
+        const size_t end = std::min(n, (chunk + 1) * grain);
+        for (size_t i = chunk * grain; i < end; ++i) {
+            std::optional<T> item = seq->Peek(i);
+            if (func(*item)) {
+                matches[chunk].PushBack(std::move(*item));
+            }
+        }
+    });
+    std::vector<size_t> offsets(chunks + 1, 0);
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        offsets[chunk + 1] = offsets[chunk] + matches[chunk].GetSize();
+    }
+    SegmentedSequence<T, ResourceAllocator<T>> items;
+    items.Resize(offsets[chunks]);
+    pool.ParallelFor(chunks, [&](size_t chunk) {
+        const T* from = matches[chunk].GetConstBegin();
+        for (size_t i = offsets[chunk]; i < offsets[chunk + 1];) {
+            const std::span<T> out = items.GetChunk(i);
+            const size_t count = std::min(out.size(), offsets[chunk + 1] - i);
+            std::copy_n(from, count, out.data());
+            from += count;
+            i += count;
+        }
+    });
+    return std::make_shared<LazySequence<T>>(std::move(items));
+}
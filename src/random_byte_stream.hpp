@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <random>
@@ -11,6 +12,8 @@
 // Intended for large-scale testing without materializing data in memory.
 class RandomByteStream final : public ReadOnlyStream<uint8_t> {
 public:
+    using ReadOnlyStream<uint8_t>::Read;
+
     RandomByteStream(size_t totalBytes, uint32_t seed = 0)
         : total_(totalBytes), pos_(0), rng_(seed == 0 ? std::random_device{}() : seed), dist_(0, 255) {
     }
@@ -27,6 +30,15 @@ public:
         return static_cast<uint8_t>(dist_(rng_));
     }
 
+    size_t Read(std::span<uint8_t> out) override {
+        const size_t n = std::min(out.size(), total_ - pos_);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<uint8_t>(dist_(rng_));
+        }
+        pos_ += n;
+        return n;
+    }
+
     size_t GetPosition() const override {
         return pos_;
     }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <fstream>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 #include "lazy_sequence.hpp"
 #include "sequence.hpp"
@@ -10,6 +15,8 @@
 template <typename T>
 class SequenceReadStream : public ReadOnlyStream<T> {
 public:
+    using ReadOnlyStream<T>::Read;
+
     SequenceReadStream(SequencePtr<T> seq) : seq_(std::move(seq)), index_(0) {
     }
 
@@ -25,6 +32,12 @@ public:
         return seq_->Get(index_ - 1);
     }
 
+    size_t Read(std::span<T> out) override {
+        const size_t n = seq_->CopyTo(index_, out);
+        index_ += n;
+        return n;
+    }
+
     size_t GetPosition() const override {
         return index_;
     }
@@ -53,6 +66,8 @@ private:
 template <typename T>
 class LazySequenceReadStream : public ReadOnlyStream<T> {
 public:
+    using ReadOnlyStream<T>::Read;
+
     LazySequenceReadStream(LazySequencePtr<T> seq) : seq_(std::move(seq)), index_(0) {
     }
 
@@ -61,11 +76,36 @@ public:
     }
 
     T Read() override {
-        if (IsEndOfStream()) {
+        std::optional<T> item = TryRead();
+        if (!item) {
             throw std::runtime_error("End of stream");
         }
+        return std::move(*item);
+    }
+
+    // The length of a filtered sequence is only an upper bound, so the end is found by asking for the next
+    // item rather than by IsEndOfStream().
+    std::optional<T> TryRead() override {
+        const std::span<const T> block = seq_->GetBlock(index_, 1);
+        if (block.empty()) {
+            return std::nullopt;
+        }
         ++index_;
-        return seq_->GetIndex(index_ - 1);
+        return block[0];
+    }
+
+    size_t Read(std::span<T> out) override {
+        size_t n = 0;
+        while (n < out.size()) {
+            const std::span<const T> block = seq_->GetBlock(index_, out.size() - n);
+            if (block.empty()) {
+                break;
+            }
+            std::copy(block.begin(), block.end(), out.begin() + n);
+            index_ += block.size();
+            n += block.size();
+        }
+        return n;
     }
 
     size_t GetPosition() const override {
@@ -84,8 +124,9 @@ public:
         return index_;
     }
 
+    // Earlier items may have been evicted by the sequence's memoization policy.
     bool IsCanGoBack() const override {
-        return true;
+        return seq_->GetMemoization().IsFull();
     }
 
 private:
@@ -96,6 +137,8 @@ private:
 template <typename T, typename Parse>
 class StringReadStream : public ReadOnlyStream<T> {
 public:
+    using ReadOnlyStream<T>::Read;
+
     StringReadStream(std::string in, Parse parse) : in_(std::move(in)), index_(0), count_(0), parse_(std::move(parse)) {
     }
 
@@ -104,19 +147,28 @@ public:
     }
 
     T Read() override {
+        std::optional<T> item = TryRead();
+        if (!item) {
+            throw std::runtime_error("End of stream");
+        }
+        return std::move(*item);
+    }
+
+    // Trailing whitespace leaves IsEndOfStream() false with nothing left to parse.
+    std::optional<T> TryRead() override {
         while (index_ < in_.size() && std::isspace(in_[index_])) {
             ++index_;
         }
         if (IsEndOfStream()) {
-            throw std::runtime_error("End of stream");
+            return std::nullopt;
         }
         size_t next = index_;
         while (next < in_.size() && !std::isspace(in_[next])) {
             ++next;
         }
-        index_ = next;
+        const size_t start = std::exchange(index_, next);
         ++count_;
-        return parse_(in_.substr(index_, next - index_));
+        return parse_(in_.substr(start, next - start));
     }
 
     size_t GetPosition() const override {
@@ -142,9 +194,24 @@ private:
     Parse parse_;
 };
 
+// Parse policy reading T verbatim from the file. FileReadStream serves bulk reads with it through a
+// single istream::read instead of one parse call per element.
+template <typename T>
+struct RawParse {
+    static_assert(std::is_trivially_copyable_v<T>, "RawParse requires a trivially copyable type");
+
+    T operator()(std::istream& is) const {
+        T item{};
+        is.read(reinterpret_cast<char*>(&item), sizeof(T));
+        return item;
+    }
+};
+
 template <typename T, typename Parse>
 class FileReadStream : public ReadOnlyStream<T> {
 public:
+    using ReadOnlyStream<T>::Read;
+
     FileReadStream(const std::string& file, Parse parse)
         : if_(file, std::ios::binary), count_(0), parse_(std::move(parse)) {
         if (!if_.is_open()) {
@@ -153,7 +220,8 @@ public:
     }
 
     bool IsEndOfStream() const override {
-        return if_.eof();
+        // peek() so the end is reported before a read fails, not after a bogus trailing element.
+        return if_.peek() == std::ifstream::traits_type::eof();
     }
 
     T Read() override {
@@ -164,6 +232,20 @@ public:
         return parse_(if_);
     }
 
+    size_t Read(std::span<T> out) override {
+        size_t n = 0;
+        if constexpr (std::is_same_v<Parse, RawParse<T>>) {
+            if_.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size_bytes()));
+            n = static_cast<size_t>(if_.gcount()) / sizeof(T);
+        } else {
+            while (n < out.size() && !IsEndOfStream()) {
+                out[n++] = parse_(if_);
+            }
+        }
+        count_ += n;
+        return n;
+    }
+
     size_t GetPosition() const override {
         return count_;
     }
@@ -181,7 +263,7 @@ public:
     }
 
 private:
-    std::ifstream if_;
+    mutable std::ifstream if_;
     size_t count_ = 0;
     Parse parse_;
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+// Index arithmetic of the segmented containers. Their blocks hold about 4 KiB of items, rounded up to a power of
+// two so that locating an item takes a few bit operations.
+//
+// SegmentedSequence is a deque of fixed blocks: position pos lies in block BlockOf(pos). SegmentedStorage, which
+// readers index without a lock, needs a directory that never moves, so its segments double instead: segment k
+// holds SegmentSize(k) items and kMaxSegments of them cover every index.
+template <typename T>
+struct SegmentLayout {
+    static constexpr size_t kBlockSize = std::bit_ceil(std::max<size_t>(16, 4096 / sizeof(T)));
+    static constexpr size_t kBlockShift = std::countr_zero(kBlockSize);
+    static constexpr size_t kMaxSegments = 64 - kBlockShift;
+
+    static constexpr size_t BlockOf(size_t pos) {
+        return pos >> kBlockShift;
+    }
+
+    static constexpr size_t OffsetInBlock(size_t pos) {
+        return pos & (kBlockSize - 1);
+    }
+
+    static constexpr size_t SegmentSize(size_t k) {
+        return kBlockSize << k;
+    }
+
+    static constexpr size_t SegmentOf(size_t index) {
+        return std::bit_width(index + kBlockSize) - 1 - kBlockShift;
+    }
+
+    // The position of index in SegmentOf(index).
+    static constexpr size_t OffsetInSegment(size_t index) {
+        return index + kBlockSize - SegmentSize(SegmentOf(index));
+    }
+};
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "checked.hpp"
+#include "ienum.hpp"
+#include "segment_layout.hpp"
+#include "sequence.hpp"
+#include "small_array_sequence.hpp"
+
+template <typename T, typename Allocator>
+class SegmentedSequence;
+
+template <typename T, typename Allocator>
+class SegmentedSequenceConstIterator : public IConstEnumerator<T> {
+public:
+    explicit SegmentedSequenceConstIterator(const SegmentedSequence<T, Allocator>* seq) : seq_(seq) {
+        LoadChunk();
+    }
+
+    bool IsEnd() const override {
+        return index_ == seq_->GetLength();
+    }
+
+    void MoveNext() override {
+        ++index_;
+        if (++it_ == end_) {
+            LoadChunk();
+        }
+    }
+
+    const T& ConstDereference() const override {
+        return *it_;
+    }
+
+    size_t Index() const override {
+        return index_;
+    }
+
+private:
+    const SegmentedSequence<T, Allocator>* seq_;
+    const T* it_ = nullptr;
+    const T* end_ = nullptr;
+    size_t index_ = 0;
+
+    void LoadChunk() {
+        const std::span<const T> chunk = seq_->GetChunk(index_);
+        it_ = chunk.data();
+        end_ = chunk.data() + chunk.size();
+    }
+};
+
+// A deque of fixed blocks, see SegmentLayout. Items never move once appended, so references to them stay valid until
+// they are removed, and growth copies nothing but the block directory, one pointer per block. Appending and
+// prepending cost O(1) apart from that, and at most one block at either end is partly unused. Blocks emptied by
+// removing items from the front are reused at the back, so a sliding window, like LazySequence's bounded
+// memoization, stops allocating once it is full. Unlike SegmentedStorage it is not thread-safe.
+template <typename T, typename Allocator = std::allocator<T>>
+class SegmentedSequence : public Sequence<T> {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using BlockAllocator = typename AllocTraits::template rebind_alloc<T*>;
+    using Layout = SegmentLayout<T>;
+
+public:
+    static constexpr size_t kBlockSize = Layout::kBlockSize;
+
+    explicit SegmentedSequence(const Allocator& alloc)
+        : alloc_(alloc), blocks_(BlockAllocator(alloc)), spare_(BlockAllocator(alloc)) {
+    }
+
+    SegmentedSequence() : SegmentedSequence(Allocator()) {
+    }
+
+    SegmentedSequence(const T* items, size_t count, const Allocator& alloc = Allocator()) : SegmentedSequence(alloc) {
+        AppendRange(std::span<const T>(items, count));
+    }
+
+    SegmentedSequence(const Sequence<T>& a, const Allocator& alloc = Allocator()) : SegmentedSequence(alloc) {
+        for (IConstEnumeratorPtr<T> it = a.GetConstEnumerator(); !it->IsEnd(); it->MoveNext()) {
+            Append(it->ConstDereference());
+        }
+    }
+
+    SegmentedSequence(SequencePtr<T> a, const Allocator& alloc = Allocator()) : SegmentedSequence(*a, alloc) {
+    }
+
+    SegmentedSequence(const SegmentedSequence& other)
+        : SegmentedSequence(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+        for (size_t i = 0; i < other.size_;) {
+            const std::span<const T> chunk = other.GetChunk(i);
+            AppendRange(chunk);
+            i += chunk.size();
+        }
+    }
+
+    SegmentedSequence(SegmentedSequence&& other) noexcept
+        : alloc_(other.alloc_),
+          blocks_(std::move(other.blocks_)),
+          spare_(std::move(other.spare_)),
+          head_(std::exchange(other.head_, 0)),
+          size_(std::exchange(other.size_, 0)) {
+    }
+
+    SegmentedSequence& operator=(const SegmentedSequence&) = delete;
+    SegmentedSequence& operator=(SegmentedSequence&&) = delete;
+
+    ~SegmentedSequence() override {
+        Clear();
+        for (size_t i = 0; i < blocks_.GetLength(); ++i) {
+            AllocTraits::deallocate(alloc_, blocks_.begin()[i], kBlockSize);
+        }
+        for (size_t i = 0; i < spare_.GetLength(); ++i) {
+            AllocTraits::deallocate(alloc_, spare_.begin()[i], kBlockSize);
+        }
+    }
+
+    const T& GetFirst() override {
+        if (size_ == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return *Slot(0);
+    }
+
+    const T& GetLast() override {
+        if (size_ == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return *Slot(size_ - 1);
+    }
+
+    const T& Get(size_t index) override {
+        if (index >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        return *Slot(index);
+    }
+
+    // Unchecked unlike Get, except in LAB1_CHECKED builds.
+    T& operator[](size_t index) {
+        CheckIndex(index, size_);
+        return *Slot(index);
+    }
+
+    const T& operator[](size_t index) const {
+        CheckIndex(index, size_);
+        return *Slot(index);
+    }
+
+    // The items from index to the end of its block or of the sequence; empty if index is past the end.
+    std::span<const T> GetChunk(size_t index) const {
+        if (index >= size_) {
+            return {};
+        }
+        const size_t offset = Layout::OffsetInBlock(head_ + index);
+        return {Slot(index), std::min(kBlockSize - offset, size_ - index)};
+    }
+
+    std::span<T> GetChunk(size_t index) {
+        const std::span<const T> chunk = std::as_const(*this).GetChunk(index);
+        return {const_cast<T*>(chunk.data()), chunk.size()};
+    }
+
+    SequencePtr<T> GetSubsequence(size_t startIndex, size_t endIndex) const override {
+        if (startIndex >= size_ || endIndex >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(startIndex) + " " +
+                                    std::to_string(endIndex) + " " + std::to_string(size_));
+        }
+        if (startIndex > endIndex) {
+            throw std::out_of_range("startIndex is greater than endIndex");
+        }
+        auto res = std::allocate_shared<SegmentedSequence>(alloc_, alloc_);
+        for (size_t i = startIndex; i <= endIndex;) {
+            const std::span<const T> chunk = GetChunk(i);
+            const size_t n = std::min(chunk.size(), endIndex - i + 1);
+            res->AppendRange(chunk.first(n));
+            i += n;
+        }
+        return res;
+    }
+
+    SequencePtr<T> GetFirst(size_t count) const override {
+        if (count == 0) {
+            return std::allocate_shared<SegmentedSequence>(alloc_, alloc_);
+        }
+        if (count > size_) {
+            throw std::out_of_range("Requested elements count is greater than size");
+        }
+        return GetSubsequence(0, count - 1);
+    }
+
+    SequencePtr<T> GetLast(size_t count) const override {
+        if (count == 0) {
+            return std::allocate_shared<SegmentedSequence>(alloc_, alloc_);
+        }
+        if (count > size_) {
+            throw std::out_of_range("Requested elements count is greater than size");
+        }
+        return GetSubsequence(size_ - count, size_ - 1);
+    }
+
+    size_t GetLength() const override {
+        return size_;
+    }
+
+    size_t GetCapacity() const override {
+        return blocks_.GetLength() * kBlockSize - head_;
+    }
+
+    size_t CopyTo(size_t startIndex, std::span<T> out) override {
+        size_t n = 0;
+        while (n < out.size()) {
+            const std::span<const T> chunk = GetChunk(startIndex + n);
+            if (chunk.empty()) {
+                break;
+            }
+            const size_t count = std::min(chunk.size(), out.size() - n);
+            std::copy_n(chunk.data(), count, out.data() + n);
+            n += count;
+        }
+        return n;
+    }
+
+    void Append(const T& item) override {
+        // Existing items never move, so item may be one of them.
+        std::construct_at(FreeTail().data(), item);
+        ++size_;
+    }
+
+    void AppendRange(std::span<const T> items) override {
+        while (!items.empty()) {
+            const std::span<T> free = FreeTail();
+            const size_t n = std::min(free.size(), items.size());
+            std::uninitialized_copy_n(items.data(), n, free.data());
+            size_ += n;
+            items = items.subspan(n);
+        }
+    }
+
+    void Prepend(const T& item) override {
+        if (head_ == 0) {
+            AddBlock(0);
+            head_ = kBlockSize;
+        }
+        std::construct_at(blocks_.begin()[Layout::BlockOf(head_ - 1)] + Layout::OffsetInBlock(head_ - 1), item);
+        --head_;
+        ++size_;
+    }
+
+    // Shifts [index, size) one slot right and puts item at index.
+    void InsertAt(const T& item, size_t index) override {
+        if (index > size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        if (index == size_) {
+            Append(item);
+            return;
+        }
+        T copy(item);
+        std::construct_at(FreeTail().data(), std::move(*Slot(size_ - 1)));
+        ++size_;
+        for (size_t i = size_ - 2; i > index; --i) {
+            *Slot(i) = std::move(*Slot(i - 1));
+        }
+        *Slot(index) = std::move(copy);
+    }
+
+    // Removes the items from startIndex through endIndex inclusive. Removing from the front frees the blocks
+    // left empty and moves nothing.
+    void RemoveRange(size_t startIndex, size_t endIndex) {
+        if (startIndex > endIndex) {
+            throw std::out_of_range("startIndex is greater than endIndex");
+        }
+        if (endIndex >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(endIndex) + " " +
+                                    std::to_string(size_));
+        }
+        const size_t count = endIndex - startIndex + 1;
+        if (startIndex == 0) {
+            DestroyRange(0, count);
+            head_ += count;
+            size_ -= count;
+            FreeLeadingBlocks();
+            return;
+        }
+        for (size_t i = endIndex + 1; i < size_; ++i) {
+            *Slot(i - count) = std::move(*Slot(i));
+        }
+        DestroyRange(size_ - count, size_);
+        size_ -= count;
+    }
+
+    // Shrinking destroys the tail; growing value-initializes the new items.
+    void Resize(size_t newSize) {
+        if (newSize <= size_) {
+            DestroyRange(newSize, size_);
+            size_ = newSize;
+            return;
+        }
+        while (size_ < newSize) {
+            const std::span<T> free = FreeTail();
+            const size_t n = std::min(free.size(), newSize - size_);
+            std::uninitialized_value_construct_n(free.data(), n);
+            size_ += n;
+        }
+    }
+
+    // Keeps the blocks for reuse, like ArraySequence keeps its capacity.
+    void Clear() override {
+        DestroyRange(0, size_);
+        head_ = 0;
+        size_ = 0;
+    }
+
+    IConstEnumeratorPtr<T> GetConstEnumerator() const override {
+        return std::make_shared<SegmentedSequenceConstIterator<T, Allocator>>(this);
+    }
+
+private:
+    static constexpr size_t kInlineBlocks = 4;
+
+    [[no_unique_address]] Allocator alloc_;
+    // Up to kInlineBlocks blocks, i.e. 16 KiB of items, need no directory allocation.
+    SmallArraySequence<T*, kInlineBlocks, BlockAllocator> blocks_;
+    // Blocks freed at the front, reused at the back before allocating new ones.
+    SmallArraySequence<T*, kInlineBlocks, BlockAllocator> spare_;
+    // Slots of the first block before the first item.
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+    T* Slot(size_t index) const {
+        const size_t pos = head_ + index;
+        return blocks_.begin()[Layout::BlockOf(pos)] + Layout::OffsetInBlock(pos);
+    }
+
+    // The unused slots after the last item, allocating a block if there are none.
+    std::span<T> FreeTail() {
+        const size_t end = head_ + size_;
+        if (end == blocks_.GetLength() * kBlockSize) {
+            AddBlock(blocks_.GetLength());
+        }
+        const size_t offset = Layout::OffsetInBlock(end);
+        return {blocks_.begin()[Layout::BlockOf(end)] + offset, kBlockSize - offset};
+    }
+
+    void AddBlock(size_t position) {
+        if (spare_.GetLength() != 0) {
+            blocks_.InsertAt(spare_.GetLast(), position);
+            spare_.RemoveRange(spare_.GetLength() - 1, spare_.GetLength() - 1);
+            return;
+        }
+        T* block = AllocTraits::allocate(alloc_, kBlockSize);
+        try {
+            blocks_.InsertAt(block, position);
+        } catch (...) {
+            AllocTraits::deallocate(alloc_, block, kBlockSize);
+            throw;
+        }
+    }
+
+    void FreeLeadingBlocks() {
+        const size_t count = Layout::BlockOf(head_);
+        if (count == 0) {
+            return;
+        }
+        spare_.AppendRange(std::span<T* const>(blocks_.begin(), count));
+        blocks_.RemoveRange(0, count - 1);
+        head_ = Layout::OffsetInBlock(head_);
+    }
+
+    void DestroyRange(size_t begin, size_t end) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = begin; i < end; ++i) {
+                std::destroy_at(Slot(i));
+            }
+        }
+    }
+};
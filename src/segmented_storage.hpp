@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+
+#include "segment_layout.hpp"
+
+// Append-only storage in segments that double in size, see SegmentLayout. Items are never relocated, so pointers
+// and references to them stay valid until the storage is destroyed, and appending costs no copy of earlier items.
+//
+// One writer may append while any number of readers call Get(i) for i < GetSize(): the size is published with
+// release semantics only after the items below it are constructed.
+template <typename T>
+class SegmentedStorage {
+    using Layout = SegmentLayout<T>;
+
+public:
+    static constexpr size_t kFirstSegment = Layout::kBlockSize;
+
+    SegmentedStorage() = default;
+
+    SegmentedStorage(const SegmentedStorage&) = delete;
+    SegmentedStorage& operator=(const SegmentedStorage&) = delete;
+
+    ~SegmentedStorage() {
+        const size_t size = size_.load(std::memory_order_relaxed);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < size; ++i) {
+                std::destroy_at(&Get(i));
+            }
+        }
+        for (size_t k = 0; k < Layout::kMaxSegments; ++k) {
+            if (T* segment = segments_[k].load(std::memory_order_relaxed)) {
+                std::allocator<T>().deallocate(segment, Layout::SegmentSize(k));
+            }
+        }
+    }
+
+    size_t GetSize() const {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // index must be below a size this thread has observed through GetSize().
+    const T& Get(size_t index) const {
+        // The segment was stored before the size that made index visible was released.
+        return segments_[Layout::SegmentOf(index)].load(std::memory_order_relaxed)[Layout::OffsetInSegment(index)];
+    }
+
+    // Single writer only. If a copy throws, the items copied before it stay appended.
+    void AppendRange(std::span<const T> items) {
+        size_t size = size_.load(std::memory_order_relaxed);
+        try {
+            for (const T& item : items) {
+                std::construct_at(Slot(size), item);
+                ++size;
+            }
+        } catch (...) {
+            size_.store(size, std::memory_order_release);
+            throw;
+        }
+        size_.store(size, std::memory_order_release);
+    }
+
+private:
+    std::array<std::atomic<T*>, Layout::kMaxSegments> segments_{};
+    std::atomic<size_t> size_ = 0;
+
+    // The uninitialized slot for index, allocating its segment when index is the first one in it.
+    T* Slot(size_t index) {
+        const size_t k = Layout::SegmentOf(index);
+        T* segment = segments_[k].load(std::memory_order_relaxed);
+        if (segment == nullptr) {
+            segment = std::allocator<T>().allocate(Layout::SegmentSize(k));
+            segments_[k].store(segment, std::memory_order_relaxed);
+        }
+        return segment + Layout::OffsetInSegment(index);
+    }
+};
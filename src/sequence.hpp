@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <span>
 
 #include "fwd.hpp"
 #include "ienum.hpp"
@@ -20,11 +21,31 @@ public:
 
     virtual size_t GetLength() const = 0;
 
+    // Copies up to out.size() elements starting at startIndex, returns how many were copied.
+    virtual size_t CopyTo(size_t startIndex, std::span<T> out) {
+        size_t n = 0;
+        for (; n < out.size() && startIndex + n < GetLength(); ++n) {
+            out[n] = Get(startIndex + n);
+        }
+        return n;
+    }
+
     virtual size_t GetCapacity() const {
         return GetLength();
     }
 
+    // Hint that the sequence is about to grow to capacity elements.
+    virtual void Reserve(size_t capacity) {
+    }
+
     virtual void Append(const T& item) = 0;
+
+    virtual void AppendRange(std::span<const T> items) {
+        for (const T& item : items) {
+            Append(item);
+        }
+    }
+
     virtual void Prepend(const T& item) = 0;
     virtual void InsertAt(const T& item, size_t index) = 0;
 
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "array_sequence.hpp"
+#include "dynamic_array.hpp"
+#include "sequence.hpp"
+
+// A read-only Sequence over elements owned by someone else. Rebinding with Reset() is O(1), which lets
+// LazySequence hand generator functions a window of its memo without copying. Subsequences are returned
+// as owning ArraySequence copies; mutating methods throw std::logic_error.
+template <typename T>
+class SequenceView : public Sequence<T> {
+public:
+    SequenceView() = default;
+
+    SequenceView(const T* data, size_t size) : data_(data), size_(size) {
+    }
+
+    void Reset(const T* data, size_t size) {
+        data_ = data;
+        size_ = size;
+    }
+
+    // Copies the viewed elements into storage owned by the view, so it stays valid after the original
+    // storage is reallocated or freed.
+    void Detach() {
+        owned_ = DynamicArray<T>(data_, size_);
+        data_ = owned_.GetConstBegin();
+    }
+
+    const T& GetFirst() override {
+        if (size_ == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return data_[0];
+    }
+
+    const T& GetLast() override {
+        if (size_ == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return data_[size_ - 1];
+    }
+
+    const T& Get(size_t index) override {
+        if (index >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        return data_[index];
+    }
+
+    SequencePtr<T> GetSubsequence(size_t startIndex, size_t endIndex) const override {
+        if (startIndex >= size_ || endIndex >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(startIndex) + " " +
+                                    std::to_string(endIndex) + " " + std::to_string(size_));
+        }
+        if (startIndex > endIndex) {
+            throw std::out_of_range("startIndex is greater than endIndex");
+        }
+        return std::make_shared<ArraySequence<T>>(data_ + startIndex, endIndex - startIndex + 1);
+    }
+
+    SequencePtr<T> GetFirst(size_t count) const override {
+        if (count == 0) {
+            return std::make_shared<ArraySequence<T>>();
+        }
+        if (count > size_) {
+            throw std::out_of_range("Requested elements count is greater than size");
+        }
+        return GetSubsequence(0, count - 1);
+    }
+
+    SequencePtr<T> GetLast(size_t count) const override {
+        if (count == 0) {
+            return std::make_shared<ArraySequence<T>>();
+        }
+        if (count > size_) {
+            throw std::out_of_range("Requested elements count is greater than size");
+        }
+        return GetSubsequence(size_ - count, size_ - 1);
+    }
+
+    size_t GetLength() const override {
+        return size_;
+    }
+
+    size_t CopyTo(size_t startIndex, std::span<T> out) override {
+        if (startIndex >= size_) {
+            return 0;
+        }
+        const size_t n = std::min(out.size(), size_ - startIndex);
+        std::copy_n(data_ + startIndex, n, out.data());
+        return n;
+    }
+
+    void Append(const T& item) override {
+        throw std::logic_error("Sequence view is read-only");
+    }
+
+    void Prepend(const T& item) override {
+        throw std::logic_error("Sequence view is read-only");
+    }
+
+    void InsertAt(const T& item, size_t index) override {
+        throw std::logic_error("Sequence view is read-only");
+    }
+
+    void Clear() override {
+        throw std::logic_error("Sequence view is read-only");
+    }
+
+    IConstEnumeratorPtr<T> GetConstEnumerator() const override {
+        return std::make_shared<ArraySequenceConstIterator<T>>(data_, size_);
+    }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+    DynamicArray<T> owned_;
+};
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "array_sequence.hpp"
+#include "checked.hpp"
+#include "ienum.hpp"
+#include "sequence.hpp"
+
+// A contiguous sequence that keeps up to N items inside the object and only takes memory from Allocator once it
+// outgrows them, after which it grows geometrically like DynamicArray. Meant for the many sequences that stay
+// tiny, such as block directories and short windows, where a heap allocation would cost more than the items.
+// Unlike ArraySequence it owns its items outright: subsequences are copies and moving an inline sequence moves
+// its items.
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallArraySequence : public Sequence<T> {
+    static_assert(N > 0, "use ArraySequence for sequences without inline storage");
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static constexpr bool kIsTrivial = std::is_trivially_copyable_v<T>;
+
+public:
+    static constexpr size_t kInlineCapacity = N;
+
+    explicit SmallArraySequence(const Allocator& alloc) : alloc_(alloc) {
+    }
+
+    SmallArraySequence() : SmallArraySequence(Allocator()) {
+    }
+
+    SmallArraySequence(const T* items, size_t count, const Allocator& alloc = Allocator())
+        : SmallArraySequence(alloc) {
+        AppendRange(std::span<const T>(items, count));
+    }
+
+    SmallArraySequence(const SmallArraySequence& other)
+        : SmallArraySequence(other.data_, other.size_,
+                             AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+    }
+
+    SmallArraySequence(SmallArraySequence&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : alloc_(other.alloc_) {
+        if (other.IsInline()) {
+            for (; size_ < other.size_; ++size_) {
+                AllocTraits::construct(alloc_, data_ + size_, std::move(other.data_[size_]));
+            }
+            other.Clear();
+        } else {
+            data_ = std::exchange(other.data_, other.InlineData());
+            capacity_ = std::exchange(other.capacity_, N);
+            size_ = std::exchange(other.size_, 0);
+        }
+    }
+
+    SmallArraySequence& operator=(const SmallArraySequence&) = delete;
+    SmallArraySequence& operator=(SmallArraySequence&&) = delete;
+
+    ~SmallArraySequence() override {
+        Clear();
+        ReleaseHeap();
+    }
+
+    const T& GetFirst() override {
+        if (size_ == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return data_[0];
+    }
+
+    const T& GetLast() override {
+        if (size_ == 0) {
+            throw std::out_of_range("Sequence is empty");
+        }
+        return data_[size_ - 1];
+    }
+
+    const T& Get(size_t index) override {
+        if (index >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        return data_[index];
+    }
+
+    SequencePtr<T> GetSubsequence(size_t startIndex, size_t endIndex) const override {
+        if (startIndex >= size_ || endIndex >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(startIndex) + " " +
+                                    std::to_string(endIndex) + " " + std::to_string(size_));
+        }
+        if (startIndex > endIndex) {
+            throw std::out_of_range("startIndex is greater than endIndex");
+        }
+        return std::allocate_shared<SmallArraySequence>(alloc_, data_ + startIndex, endIndex - startIndex + 1,
+                                                        alloc_);
+    }
+
+    SequencePtr<T> GetFirst(size_t count) const override {
+        if (count == 0) {
+            return std::allocate_shared<SmallArraySequence>(alloc_, alloc_);
+        }
+        if (count > size_) {
+            throw std::out_of_range("Requested elements count is greater than size");
+        }
+        return GetSubsequence(0, count - 1);
+    }
+
+    SequencePtr<T> GetLast(size_t count) const override {
+        if (count == 0) {
+            return std::allocate_shared<SmallArraySequence>(alloc_, alloc_);
+        }
+        if (count > size_) {
+            throw std::out_of_range("Requested elements count is greater than size");
+        }
+        return GetSubsequence(size_ - count, size_ - 1);
+    }
+
+    size_t GetLength() const override {
+        return size_;
+    }
+
+    size_t GetCapacity() const override {
+        return capacity_;
+    }
+
+    // Unchecked unlike Get, except in LAB1_CHECKED builds.
+    T& operator[](size_t index) {
+        CheckIndex(index, size_);
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const {
+        CheckIndex(index, size_);
+        return data_[index];
+    }
+
+    T* data() {
+        return data_;
+    }
+
+    const T* data() const {
+        return data_;
+    }
+
+    bool IsInline() const {
+        return data_ == InlineData();
+    }
+
+    T* begin() {
+        return data_;
+    }
+
+    T* end() {
+        return data_ + size_;
+    }
+
+    const T* begin() const {
+        return data_;
+    }
+
+    const T* end() const {
+        return data_ + size_;
+    }
+
+    size_t CopyTo(size_t startIndex, std::span<T> out) override {
+        if (startIndex >= size_) {
+            return 0;
+        }
+        const size_t n = std::min(out.size(), size_ - startIndex);
+        std::copy_n(data_ + startIndex, n, out.data());
+        return n;
+    }
+
+    void Reserve(size_t capacity) override {
+        if (capacity > capacity_) {
+            Reallocate(capacity);
+        }
+    }
+
+    void Append(const T& item) override {
+        if (size_ == capacity_) {
+            // The argument may live in this sequence, so it is copied before the storage moves.
+            T copy(item);
+            Grow(size_ + 1);
+            AllocTraits::construct(alloc_, data_ + size_, std::move(copy));
+        } else {
+            AllocTraits::construct(alloc_, data_ + size_, item);
+        }
+        ++size_;
+    }
+
+    void AppendRange(std::span<const T> items) override {
+        if (size_ + items.size() > capacity_) {
+            if (items.data() >= data_ && items.data() < data_ + size_) {
+                // Same aliasing concern as in Append.
+                const SmallArraySequence copy(items.data(), items.size(), alloc_);
+                AppendRange(std::span<const T>(copy.begin(), copy.end()));
+                return;
+            }
+            Grow(size_ + items.size());
+        }
+        if constexpr (kIsTrivial) {
+            if (!items.empty()) {
+                std::memcpy(data_ + size_, items.data(), items.size() * sizeof(T));
+            }
+            size_ += items.size();
+        } else {
+            for (const T& item : items) {
+                AllocTraits::construct(alloc_, data_ + size_, item);
+                ++size_;
+            }
+        }
+    }
+
+    void Prepend(const T& item) override {
+        InsertAt(item, 0);
+    }
+
+    // Shifts [index, size) one slot right and puts item at index.
+    void InsertAt(const T& item, size_t index) override {
+        if (index > size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(index) + " " + std::to_string(size_));
+        }
+        if (index == size_) {
+            Append(item);
+            return;
+        }
+        T copy(item);
+        if (size_ == capacity_) {
+            Grow(size_ + 1);
+        }
+        AllocTraits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+        std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
+        data_[index] = std::move(copy);
+        ++size_;
+    }
+
+    // Removes the items from startIndex through endIndex inclusive and shifts the tail left.
+    void RemoveRange(size_t startIndex, size_t endIndex) {
+        if (startIndex > endIndex) {
+            throw std::out_of_range("startIndex is greater than endIndex");
+        }
+        if (endIndex >= size_) {
+            throw std::out_of_range("Index is out of range: " + std::to_string(endIndex) + " " +
+                                    std::to_string(size_));
+        }
+        const size_t count = endIndex - startIndex + 1;
+        std::move(data_ + endIndex + 1, data_ + size_, data_ + startIndex);
+        DestroyRange(size_ - count, size_);
+        size_ -= count;
+    }
+
+    // Keeps the capacity, inline or not.
+    void Clear() override {
+        DestroyRange(0, size_);
+        size_ = 0;
+    }
+
+    IConstEnumeratorPtr<T> GetConstEnumerator() const override {
+        return std::make_shared<ArraySequenceConstIterator<T>>(data_, size_);
+    }
+
+private:
+    alignas(T) std::byte inline_[N * sizeof(T)];
+    [[no_unique_address]] Allocator alloc_;
+    T* data_ = InlineData();
+    size_t size_ = 0;
+    size_t capacity_ = N;
+
+    T* InlineData() {
+        return reinterpret_cast<T*>(inline_);
+    }
+
+    const T* InlineData() const {
+        return reinterpret_cast<const T*>(inline_);
+    }
+
+    void Grow(size_t minCapacity) {
+        Reallocate(std::max(minCapacity, capacity_ * 2));
+    }
+
+    // Moves the items to capacity slots from Allocator; capacity must exceed the current one.
+    void Reallocate(size_t capacity) {
+        T* fresh = AllocTraits::allocate(alloc_, capacity);
+        if constexpr (kIsTrivial) {
+            if (size_ != 0) {
+                std::memcpy(fresh, data_, size_ * sizeof(T));
+            }
+        } else {
+            size_t moved = 0;
+            try {
+                for (; moved < size_; ++moved) {
+                    AllocTraits::construct(alloc_, fresh + moved, std::move_if_noexcept(data_[moved]));
+                }
+            } catch (...) {
+                for (size_t i = 0; i < moved; ++i) {
+                    AllocTraits::destroy(alloc_, fresh + i);
+                }
+                AllocTraits::deallocate(alloc_, fresh, capacity);
+                throw;
+            }
+            DestroyRange(0, size_);
+        }
+        ReleaseHeap();
+        data_ = fresh;
+        capacity_ = capacity;
+    }
+
+    void ReleaseHeap() {
+        if (!IsInline()) {
+            AllocTraits::deallocate(alloc_, data_, capacity_);
+        }
+    }
+
+    void DestroyRange(size_t begin, size_t end) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = begin; i < end; ++i) {
+                AllocTraits::destroy(alloc_, data_ + i);
+            }
+        }
+    }
+};
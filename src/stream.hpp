@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
 
 template <typename T>
 class ReadOnlyStream {
@@ -9,8 +12,27 @@ public:
 
     virtual bool IsEndOfStream() const = 0;
 
+    // Reading past the end is an error; see TryRead.
     virtual T Read() = 0;
 
+    // Returns std::nullopt at end of stream. Streams that can only tell they are exhausted by trying to read,
+    // such as encoders over lazy sources, report the end here without throwing.
+    virtual std::optional<T> TryRead() {
+        if (IsEndOfStream()) {
+            return std::nullopt;
+        }
+        return Read();
+    }
+
+    // Reads up to out.size() elements and returns how many were read; fewer only at end of stream.
+    virtual size_t Read(std::span<T> out) {
+        size_t n = 0;
+        while (n < out.size() && !IsEndOfStream()) {
+            out[n++] = Read();
+        }
+        return n;
+    }
+
     virtual size_t GetPosition() const = 0;
 
     virtual bool IsCanSeek() const = 0;
@@ -18,6 +40,17 @@ public:
     virtual size_t Seek(size_t index) = 0;
 
     virtual bool IsCanGoBack() const = 0;
+
+    // Streams backed by memory can hand out their elements without copying them.
+    virtual bool IsCanView() const {
+        return false;
+    }
+
+    // Returns a view of up to maxCount next elements and moves past them; fewer only at end of stream.
+    // The view stays valid for the lifetime of the stream.
+    virtual std::span<const T> ReadView(size_t maxCount) {
+        throw std::logic_error("Stream does not support views");
+    }
 };
 
 template <typename T>
@@ -28,4 +61,16 @@ public:
     virtual size_t GetPosition() const = 0;
 
     virtual size_t Write(const T& item) = 0;
+
+    // Writes all items and returns the new position, like Write(item).
+    virtual size_t Write(std::span<const T> items) {
+        for (const T& item : items) {
+            Write(item);
+        }
+        return GetPosition();
+    }
+
+    // Pushes buffered items to the underlying storage.
+    virtual void Flush() {
+    }
 };
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads executing submitted tasks in FIFO order.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+        threads = std::max<size_t>(1, threads);
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] {
+                WorkerLoop();
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    size_t GetThreadCount() const {
+        return workers_.size();
+    }
+
+    template <typename Func>
+    std::future<void> Submit(Func func) {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::move(func));
+        std::future<void> res = task->get_future();
+        {
+            std::lock_guard lock(mutex_);
+            tasks_.emplace([task] {
+                (*task)();
+            });
+        }
+        cv_.notify_one();
+        return res;
+    }
+
+    // Calls func(i) for every i in [0, count) and waits for all calls. The calling thread takes part,
+    // so nested calls from a worker cannot deadlock. The first exception thrown is rethrown here.
+    template <typename Func>
+    void ParallelFor(size_t count, Func func) {
+        std::atomic<size_t> next = 0;
+        auto body = [&next, &func, count] {
+            for (size_t i = next++; i < count; i = next++) {
+                func(i);
+            }
+        };
+        const size_t helpers = std::min(workers_.size(), count > 0 ? count - 1 : 0);
+        std::vector<std::future<void>> futures;
+        futures.reserve(helpers);
+        for (size_t i = 0; i < helpers; ++i) {
+            futures.push_back(Submit(body));
+        }
+        std::exception_ptr error;
+        try {
+            body();
+        } catch (...) {
+            error = std::current_exception();
+            next = count;
+        }
+        for (auto& future : futures) {
+            // Run queued tasks while waiting: a helper may still sit in the queue behind this very call.
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                if (!RunPendingTask()) {
+                    future.wait();
+                }
+            }
+            try {
+                future.get();
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    bool RunPendingTask() {
+        std::function<void()> task;
+        {
+            std::lock_guard lock(mutex_);
+            if (tasks_.empty()) {
+                return false;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+        return true;
+    }
+
+    void WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this] {
+                    return stopped_ || !tasks_.empty();
+                });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopped_ = false;
+};
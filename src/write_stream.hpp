@@ -1,6 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 #include "sequence.hpp"
 #include "stream.hpp"
@@ -8,6 +14,8 @@
 template <typename T>
 class SequenceWriteStream : public WriteOnlyStream<T> {
 public:
+    using WriteOnlyStream<T>::Write;
+
     SequenceWriteStream(SequencePtr<T> seq) : seq_(std::move(seq)) {
     }
 
@@ -20,31 +28,151 @@ public:
         return seq_->GetLength();
     }
 
+    size_t Write(std::span<const T> items) override {
+        seq_->Reserve(seq_->GetLength() + items.size());
+        seq_->AppendRange(items);
+        return seq_->GetLength();
+    }
+
 private:
     SequencePtr<T> seq_;
 };
 
+// Serialize policy writing T verbatim. FileWriteStream copies such items straight into its buffer
+// instead of calling the serializer per item.
+template <typename T>
+struct RawSerialize {
+    static_assert(std::is_trivially_copyable_v<T>, "RawSerialize requires a trivially copyable type");
+
+    void operator()(std::ostream& os, const T& item) const {
+        os.write(reinterpret_cast<const char*>(&item), sizeof(T));
+    }
+};
+
 template <typename T, typename Serialize>
 class FileWriteStream : public WriteOnlyStream<T> {
 public:
-    FileWriteStream(const std::string& file, Serialize serialize)
-        : of_(file, std::ios::binary), index_(0), serialize_(std::move(serialize)) {
+    using WriteOnlyStream<T>::Write;
+
+    static constexpr size_t kDefaultBufferSize = 64 * 1024;
+    static constexpr size_t kBufferAlignment = 4096;
+
+    FileWriteStream(const std::string& file, Serialize serialize, size_t bufferSizeBytes = kDefaultBufferSize)
+        : bufferSize_(AlignUp(std::max(bufferSizeBytes, sizeof(T)))),
+          buffer_(static_cast<char*>(std::aligned_alloc(kBufferAlignment, bufferSize_))),
+          index_(0),
+          serialize_(std::move(serialize)) {
+        if (!buffer_) {
+            throw std::bad_alloc();
+        }
+        // The buffer has to be installed before open(). Raw mode fills buffer_ itself and writes it
+        // in whole blocks, so the file buffer is disabled; otherwise serialize_ writes into buffer_.
+        if constexpr (kRaw) {
+            of_.rdbuf()->pubsetbuf(nullptr, 0);
+        } else {
+            of_.rdbuf()->pubsetbuf(buffer_.get(), static_cast<std::streamsize>(bufferSize_));
+        }
+        of_.open(file, std::ios::binary);
         if (!of_.is_open()) {
             throw std::runtime_error("Cannot open file");
         }
     }
 
+    ~FileWriteStream() override {
+        try {
+            Flush();
+        } catch (const std::exception&) {
+        }
+    }
+
     size_t GetPosition() const override {
         return index_;
     }
 
     size_t Write(const T& item) override {
-        serialize_(of_, item);
+        if constexpr (kRaw) {
+            if (used_ + sizeof(T) > bufferSize_) {
+                FlushBuffer();
+            }
+            std::memcpy(buffer_.get() + used_, &item, sizeof(T));
+            used_ += sizeof(T);
+        } else {
+            serialize_(of_, item);
+        }
         ++index_;
         return index_;
     }
 
+    size_t Write(std::span<const T> items) override {
+        if constexpr (kRaw) {
+            const char* bytes = reinterpret_cast<const char*>(items.data());
+            size_t left = items.size_bytes();
+            while (left != 0) {
+                if (used_ == 0 && left >= bufferSize_) {
+                    // Large writes skip the copy into the buffer.
+                    WriteBytes(bytes, left);
+                    break;
+                }
+                const size_t chunk = std::min(left, bufferSize_ - used_);
+                std::memcpy(buffer_.get() + used_, bytes, chunk);
+                used_ += chunk;
+                bytes += chunk;
+                left -= chunk;
+                if (used_ == bufferSize_) {
+                    FlushBuffer();
+                }
+            }
+        } else {
+            for (const T& item : items) {
+                serialize_(of_, item);
+            }
+        }
+        index_ += items.size();
+        return index_;
+    }
+
+    void Flush() override {
+        FlushBuffer();
+        of_.flush();
+        if (!of_) {
+            throw std::runtime_error("Cannot write file");
+        }
+    }
+
 private:
+    static constexpr bool kRaw = std::is_same_v<Serialize, RawSerialize<T>>;
+
+    struct FreeDeleter {
+        void operator()(char* p) const {
+            std::free(p);
+        }
+    };
+
+    static size_t AlignUp(size_t n) {
+        return (n + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+    }
+
+    void WriteBytes(const char* bytes, size_t n) {
+        of_.write(bytes, static_cast<std::streamsize>(n));
+        if (!of_) {
+            throw std::runtime_error("Cannot write file");
+        }
+    }
+
+    void FlushBuffer() {
+        if constexpr (kRaw) {
+            if (used_ != 0) {
+                WriteBytes(buffer_.get(), used_);
+                used_ = 0;
+            }
+        }
+    }
+
+    // Declared before of_ so that the file buffer outlives the stream using it.
+    const size_t bufferSize_;
+    std::unique_ptr<char, FreeDeleter> buffer_;
+    size_t used_ = 0;
+
     std::ofstream of_;
     size_t index_ = 0;
     Serialize serialize_;
@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <utility>
+
+#include "arena.hpp"
+#include "array_sequence.hpp"
+#include "lazy_sequence.hpp"
+#include "segmented_sequence.hpp"
+#include "small_array_sequence.hpp"
+
+namespace {
+
+// Forwards to new/delete and counts the calls that reach it.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t outstanding = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+template <typename T>
+using PmrArraySequence = ArraySequence<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace
+
+TEST_CASE("MonotonicArena") {
+    CountingResource upstream;
+    {
+        MonotonicArena arena(256, &upstream);
+        for (size_t alignment : {1, 2, 8, 16, 64}) {
+            for (int i = 0; i < 100; ++i) {
+                void* p = arena.allocate(24, alignment);
+                REQUIRE(reinterpret_cast<std::uintptr_t>(p) % alignment == 0);
+            }
+        }
+        REQUIRE(arena.GetAllocatedBytes() == 500 * 24);
+        // Chunks double, so the number of upstream calls is logarithmic.
+        REQUIRE(upstream.allocations <= 8);
+
+        arena.Release();
+        REQUIRE(upstream.outstanding == 0);
+        void* large = arena.allocate(10000, 8);
+        REQUIRE(large != nullptr);
+        REQUIRE(upstream.outstanding == 1);
+        // Deallocation is a no-op: the chunk goes back upstream with the arena.
+        arena.deallocate(large, 10000, 8);
+        REQUIRE(upstream.outstanding == 1);
+    }
+    REQUIRE(upstream.outstanding == 0);
+}
+
+TEST_CASE("SizeClassPool reuses blocks") {
+    CountingResource upstream;
+    {
+        SizeClassPool pool(4096, &upstream);
+        std::pmr::polymorphic_allocator<int> alloc(&pool);
+        for (int round = 0; round < 100; ++round) {
+            PmrArraySequence<int> seq(alloc);
+            for (int i = 0; i < 200; ++i) {
+                seq.Append(i);
+            }
+            auto sub = seq.GetSubsequence(10, 19);
+            REQUIRE(sub->GetLength() == 10);
+            REQUIRE(sub->Get(9) == 19);
+        }
+        // Only the first round takes slabs from upstream.
+        const size_t slabs = pool.GetSlabCount();
+        REQUIRE(upstream.allocations == slabs);
+
+        // Large blocks bypass the pool.
+        void* big = pool.allocate(1 << 20, 16);
+        REQUIRE(upstream.allocations == slabs + 1);
+        pool.deallocate(big, 1 << 20, 16);
+    }
+    REQUIRE(upstream.outstanding == 0);
+}
+
+TEST_CASE("ArraySequence with a non-trivial type in an arena") {
+    MonotonicArena arena;
+    PmrArraySequence<std::string> seq{std::pmr::polymorphic_allocator<std::string>(&arena)};
+    for (int i = 0; i < 100; ++i) {
+        seq.Append(std::to_string(i));
+    }
+    seq.InsertAt("x", 50);
+    REQUIRE(seq.Get(50) == "x");
+    REQUIRE(seq.GetLast(3)->Get(2) == "99");
+    REQUIRE(arena.GetAllocatedBytes() > 0);
+}
+
+TEST_CASE("SmallArraySequence allocates only past its inline capacity") {
+    CountingResource upstream;
+    std::pmr::polymorphic_allocator<std::string> alloc(&upstream);
+    {
+        SmallArraySequence<std::string, 4, std::pmr::polymorphic_allocator<std::string>> seq(alloc);
+        seq.Append("b");
+        seq.Append("c");
+        seq.Append("d");
+        seq.Prepend("a");
+        REQUIRE(seq.IsInline());
+        REQUIRE(upstream.allocations == 0);
+
+        auto inlineMoved = std::move(seq);
+        REQUIRE(inlineMoved.GetLength() == 4);
+        REQUIRE(seq.GetLength() == 0);
+        REQUIRE(upstream.allocations == 0);
+
+        inlineMoved.Append(inlineMoved.Get(0));
+        REQUIRE_FALSE(inlineMoved.IsInline());
+        REQUIRE(upstream.allocations == 1);
+        inlineMoved.RemoveRange(1, 2);
+        REQUIRE(inlineMoved.Get(1) == "d");
+        REQUIRE(inlineMoved.GetLast() == "a");
+
+        auto heapMoved = std::move(inlineMoved);
+        REQUIRE(heapMoved.GetLength() == 3);
+        REQUIRE(inlineMoved.IsInline());
+        REQUIRE(upstream.allocations == 1);
+    }
+    REQUIRE(upstream.outstanding == 0);
+}
+
+TEST_CASE("LazySequence memo allocates nothing until it holds items") {
+    CountingResource upstream;
+    {
+        ScopedDefaultResource scope(&upstream);
+        auto squares = LazySequence<int>::FromFunction([](size_t i) {
+                           return static_cast<int>(i * i);
+                       })
+                           ->Map([](int x) {
+                               return x + 1;
+                           });
+        REQUIRE(upstream.allocations == 0);
+
+        // One memo block and no block directory for a short sequence.
+        const int items[] = {1, 2, 3};
+        LazySequence<int> small(items, 3);
+        REQUIRE(upstream.allocations == 1);
+    }
+    REQUIRE(upstream.outstanding == 0);
+}
+
+TEST_CASE("LazySequence storage follows the default resource") {
+    CountingResource upstream;
+    SizeClassPool pool(64 * 1024, &upstream);
+    {
+        ScopedDefaultResource scope(&pool);
+        auto start = std::make_shared<ArraySequence<int64_t>>();
+        start->Append(1);
+        start->Append(1);
+        auto fib = std::make_shared<LazySequence<int64_t>>(
+            [](SequencePtr<int64_t> last2) {
+                return (last2->Get(0) + last2->Get(1)) % 1000000007;
+            },
+            start, 2);
+        REQUIRE(fib->GetIndex(9) == 55);
+        fib->GetIndex(100000);
+    }
+    REQUIRE(std::pmr::get_default_resource() == std::pmr::new_delete_resource());
+    // The pool recycles small allocations, leaving only the memo's blocks, which are larger than its classes.
+    REQUIRE(upstream.allocations < 100001 / SegmentedSequence<int64_t>::kBlockSize + 20);
+}
@@ -0,0 +1,259 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "array_sequence.hpp"
+#include "base64_decode_stream.hpp"
+#include "base64_encode_stream.hpp"
+#include "base64_kernel.hpp"
+#include "parallel_base64_encoder.hpp"
+#include "random_byte_stream.hpp"
+#include "read_stream.hpp"
+#include "write_stream.hpp"
+
+namespace {
+
+std::vector<uint8_t> RandomBytes(size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> res(n);
+    for (auto& b : res) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return res;
+}
+
+std::string EncodeWithStream(const std::vector<uint8_t>& bytes, size_t bufferSize, Base64Kernel kernel) {
+    auto seq = std::make_shared<ArraySequence<uint8_t>>(bytes.data(), static_cast<int>(bytes.size()));
+    Base64EncodeStream encoder(std::make_unique<SequenceReadStream<uint8_t>>(std::move(seq)), bufferSize, kernel);
+    std::string res(Base64EncodedLength(bytes.size()) + 1, '\0');
+    res.resize(encoder.Read(std::span<char>(res)));
+    return res;
+}
+
+std::vector<uint8_t> DecodeWithStream(const std::string& text, size_t bufferSize, Base64DecodeMode mode,
+                                      Base64Kernel kernel = Base64BestKernel()) {
+    auto seq = std::make_shared<ArraySequence<char>>(text.data(), static_cast<int>(text.size()));
+    Base64DecodeStream decoder(std::make_unique<SequenceReadStream<char>>(std::move(seq)), bufferSize, mode, kernel);
+    std::vector<uint8_t> res(text.size() + 1);
+    res.resize(decoder.Read(std::span<uint8_t>(res)));
+    return res;
+}
+
+std::vector<uint8_t> Bytes(const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+const Base64Kernel kKernels[] = {Base64Kernel::Scalar, Base64Kernel::Ssse3, Base64Kernel::Avx2, Base64Kernel::Avx512};
+
+}  // namespace
+
+TEST_CASE("Base64 known vectors") {
+    const std::pair<std::string, std::string> cases[] = {
+        {"f", "Zg=="},         {"fo", "Zm8="},         {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    };
+    for (Base64Kernel kernel : kKernels) {
+        for (const auto& [plain, encoded] : cases) {
+            const std::vector<uint8_t> bytes(plain.begin(), plain.end());
+            for (size_t bufferSize : {1, 2, 3, 4, 1024}) {
+                REQUIRE(EncodeWithStream(bytes, bufferSize, kernel) == encoded);
+            }
+        }
+    }
+}
+
+TEST_CASE("Base64 vector kernels match scalar") {
+    const auto bytes = RandomBytes(1024, 7);
+    for (Base64Kernel kernel : kKernels) {
+        if (!Base64IsKernelSupported(kernel)) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 4; ++offset) {
+            for (size_t n = 0; n + offset <= 300; ++n) {
+                std::string expected(n / 3 * 4, '\0');
+                std::string got(n / 3 * 4, '\0');
+                REQUIRE(Base64EncodeTriplets(Base64Kernel::Scalar, bytes.data() + offset, n, expected.data()) ==
+                        n / 3 * 3);
+                REQUIRE(Base64EncodeTriplets(kernel, bytes.data() + offset, n, got.data()) == n / 3 * 3);
+                REQUIRE(got == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Base64EncodeStream is identical across kernels and buffer sizes") {
+    const auto bytes = RandomBytes(100000, 42);
+    const std::string expected = EncodeWithStream(bytes, 3, Base64Kernel::Scalar);
+    REQUIRE(expected.size() == (bytes.size() + 2) / 3 * 4);
+    for (Base64Kernel kernel : kKernels) {
+        for (size_t bufferSize : {1, 47, 48, 4096, 65536}) {
+            REQUIRE(EncodeWithStream(bytes, bufferSize, kernel) == expected);
+        }
+    }
+}
+
+TEST_CASE("Parallel Base64 encoder matches the serial stream") {
+    ThreadPool pool(4);
+    for (size_t n : {0, 1, 2, 3, 100, 3000, 100001}) {
+        const auto bytes = RandomBytes(n, static_cast<uint32_t>(n));
+        const std::string expected = EncodeWithStream(bytes, 4096, Base64Kernel::Scalar);
+        for (size_t chunkBytes : {1, 3, 10, 999, 1 << 16}) {
+            ParallelBase64Encoder encoder(pool, chunkBytes);
+            std::string got(Base64EncodedLength(n), '\0');
+            encoder.Encode(bytes, std::span<char>(got));
+            REQUIRE(got == expected);
+        }
+    }
+}
+
+TEST_CASE("Parallel Base64 encoder over streams") {
+    ThreadPool pool(3);
+    const size_t n = 200000;
+    RandomByteStream plainSrc(n, 11);
+    std::vector<uint8_t> plain(n);
+    plainSrc.Read(std::span<uint8_t>(plain));
+    const std::string expected = EncodeWithStream(plain, 4096, Base64Kernel::Scalar);
+
+    auto seq = std::make_shared<ArraySequence<char>>();
+    SequenceWriteStream<char> out(seq);
+    RandomByteStream src(n, 11);
+    REQUIRE(ParallelBase64Encoder(pool, 3000).Encode(src, out) == expected.size());
+    std::string got(seq->GetLength(), '\0');
+    seq->CopyTo(0, std::span<char>(got));
+    REQUIRE(got == expected);
+}
+
+TEST_CASE("Base64 decode kernels match scalar") {
+    const auto bytes = RandomBytes(3000, 3);
+    const std::string text = EncodeWithStream(bytes, 4096, Base64Kernel::Scalar);
+    for (Base64Kernel kernel : kKernels) {
+        if (!Base64IsKernelSupported(kernel)) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 8; offset += 4) {
+            for (size_t n = 0; n + offset <= 400; ++n) {
+                std::vector<uint8_t> got(n / 4 * 3);
+                REQUIRE(Base64DecodeQuartets(kernel, text.data() + offset, n, got.data()) == n / 4 * 4);
+                REQUIRE(std::equal(got.begin(), got.end(), bytes.begin() + offset / 4 * 3));
+            }
+        }
+
+        // Every kernel stops right before the first quartet holding a bad char.
+        for (size_t pos = 0; pos < 200; ++pos) {
+            std::string broken = text.substr(0, 256);
+            broken[pos] = '*';
+            std::vector<uint8_t> got(broken.size());
+            REQUIRE(Base64DecodeQuartets(kernel, broken.data(), broken.size(), got.data()) == pos / 4 * 4);
+        }
+    }
+}
+
+TEST_CASE("Base64DecodeStream round trip") {
+    for (size_t n : {0, 1, 2, 3, 4, 5, 100, 10000}) {
+        const auto bytes = RandomBytes(n, static_cast<uint32_t>(n) + 1);
+        const std::string text = EncodeWithStream(bytes, 4096, Base64Kernel::Scalar);
+        for (Base64Kernel kernel : kKernels) {
+            for (size_t bufferSize : {1, 3, 4, 63, 4096}) {
+                REQUIRE(DecodeWithStream(text, bufferSize, Base64DecodeMode::Strict, kernel) == bytes);
+                REQUIRE(DecodeWithStream(text, bufferSize, Base64DecodeMode::Lenient, kernel) == bytes);
+            }
+        }
+    }
+    REQUIRE(DecodeWithStream("Zm9vYmFy", 4, Base64DecodeMode::Strict) == Bytes("foobar"));
+    REQUIRE(DecodeWithStream("Zm9vYg==", 4, Base64DecodeMode::Strict) == Bytes("foob"));
+    REQUIRE(DecodeWithStream("Zm9vYmE=", 5, Base64DecodeMode::Strict) == Bytes("fooba"));
+}
+
+TEST_CASE("Base64DecodeStream strict mode rejects malformed input") {
+    for (const std::string text :
+         {"Zm9v YmFy", "Zm9vYg", "Zm9vY", "Zm9vYg=", "Zm9vYg==Zm9v", "Zm*v", "Z===", "Zm9vYg==\n",
+          // Non-zero bits past the final byte.
+          "QR==", "Zm9vYmF="}) {
+        for (size_t bufferSize : {1, 4, 1024}) {
+            REQUIRE_THROWS_AS(DecodeWithStream(text, bufferSize, Base64DecodeMode::Strict), std::runtime_error);
+        }
+    }
+}
+
+TEST_CASE("Base64DecodeStream lenient mode") {
+    for (size_t bufferSize : {1, 2, 4, 1024}) {
+        REQUIRE(DecodeWithStream(" Zm9v\r\nYmFy\n", bufferSize, Base64DecodeMode::Lenient) == Bytes("foobar"));
+        REQUIRE(DecodeWithStream("Zm9vYg", bufferSize, Base64DecodeMode::Lenient) == Bytes("foob"));
+        REQUIRE(DecodeWithStream("Zm9vYmE", bufferSize, Base64DecodeMode::Lenient) == Bytes("fooba"));
+        REQUIRE(DecodeWithStream("Zm9v\tYg=\n", bufferSize, Base64DecodeMode::Lenient) == Bytes("foob"));
+        REQUIRE(DecodeWithStream("Zm9vYg==\n\n", bufferSize, Base64DecodeMode::Lenient) == Bytes("foob"));
+        REQUIRE(DecodeWithStream("QR==", bufferSize, Base64DecodeMode::Lenient) == Bytes("A"));
+        REQUIRE_THROWS_AS(DecodeWithStream("Zm9vY", bufferSize, Base64DecodeMode::Lenient), std::runtime_error);
+        REQUIRE_THROWS_AS(DecodeWithStream("Zm*v", bufferSize, Base64DecodeMode::Lenient), std::runtime_error);
+    }
+}
+
+TEST_CASE("Base64 URL-safe variant") {
+    const std::vector<uint8_t> bytes = {0xfb, 0xff, 0xbf, 0xfe};
+    auto seq = std::make_shared<ArraySequence<uint8_t>>(bytes.data(), static_cast<int>(bytes.size()));
+    Base64UrlEncodeStream encoder(std::make_unique<SequenceReadStream<uint8_t>>(std::move(seq)));
+    std::string text(16, '\0');
+    text.resize(encoder.Read(std::span<char>(text)));
+    REQUIRE(text == "-_-__g");
+
+    const auto plain = RandomBytes(5000, 5);
+    for (Base64Kernel kernel : kKernels) {
+        if (!Base64IsKernelSupported(kernel)) {
+            continue;
+        }
+        std::string standard(plain.size() / 3 * 4, '\0');
+        std::string url(plain.size() / 3 * 4, '\0');
+        Base64EncodeTriplets(kernel, plain.data(), plain.size(), standard.data());
+        Base64EncodeTriplets<Base64Alphabet::Url>(kernel, plain.data(), plain.size(), url.data());
+        std::replace(standard.begin(), standard.end(), '+', '-');
+        std::replace(standard.begin(), standard.end(), '/', '_');
+        REQUIRE(url == standard);
+
+        std::vector<uint8_t> decoded(plain.size() / 3 * 3);
+        REQUIRE(Base64DecodeQuartets<Base64Alphabet::Url>(kernel, url.data(), url.size(), decoded.data()) ==
+                url.size());
+        REQUIRE(std::equal(decoded.begin(), decoded.end(), plain.begin()));
+        // Each alphabet rejects the other's chars 62 and 63.
+        REQUIRE(Base64DecodeQuartets(kernel, "AAA-", 4, decoded.data()) == 0);
+        REQUIRE(Base64DecodeQuartets<Base64Alphabet::Url>(kernel, "AAA+", 4, decoded.data()) == 0);
+    }
+
+    for (size_t n : {0, 1, 2, 3, 100, 10001}) {
+        const auto original = RandomBytes(n, static_cast<uint32_t>(n) + 9);
+        auto src = std::make_shared<ArraySequence<uint8_t>>(original.data(), static_cast<int>(original.size()));
+        auto enc = std::make_unique<Base64UrlEncodeStream>(std::make_unique<SequenceReadStream<uint8_t>>(src), 7);
+        Base64UrlDecodeStream decoder(std::move(enc), 5);
+        std::vector<uint8_t> got(n + 1);
+        got.resize(decoder.Read(std::span<uint8_t>(got)));
+        REQUIRE(got == original);
+    }
+}
+
+TEST_CASE("Base64 MIME variant wraps lines") {
+    const auto plain = RandomBytes(1000, 8);
+    const std::string flat = EncodeWithStream(plain, 4096, Base64Kernel::Scalar);
+    for (size_t bufferSize : {1, 57, 100, 4096}) {
+        auto seq = std::make_shared<ArraySequence<uint8_t>>(plain.data(), static_cast<int>(plain.size()));
+        auto encoder =
+            std::make_unique<Base64MimeEncodeStream>(std::make_unique<SequenceReadStream<uint8_t>>(seq), bufferSize);
+        std::string text(2 * flat.size(), '\0');
+        text.resize(encoder->Read(std::span<char>(text)));
+
+        std::string expected;
+        for (size_t pos = 0; pos < flat.size(); pos += 76) {
+            if (pos != 0) {
+                expected += "\r\n";
+            }
+            expected += flat.substr(pos, 76);
+        }
+        REQUIRE(text == expected);
+
+        auto chars = std::make_shared<ArraySequence<char>>(text.data(), static_cast<int>(text.size()));
+        Base64MimeDecodeStream decoder(std::make_unique<SequenceReadStream<char>>(chars), bufferSize);
+        std::vector<uint8_t> got(plain.size() + 1);
+        got.resize(decoder.Read(std::span<uint8_t>(got)));
+        REQUIRE(got == plain);
+    }
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "array_sequence.hpp"
+#include "concurrent_lazy_sequence.hpp"
+#include "lazy_sequence.hpp"
+#include "parallel_sequence.hpp"
+#include "segmented_storage.hpp"
+#include "thread_pool.hpp"
+
+TEST_CASE("Segmented storage keeps items in place") {
+    SegmentedStorage<std::string> storage;
+    std::vector<std::string> items;
+    for (int i = 0; i < 100000; ++i) {
+        items.push_back(std::to_string(i));
+    }
+    storage.AppendRange(std::span<const std::string>(items.data(), 1));
+    const std::string* first = &storage.Get(0);
+    storage.AppendRange(std::span<const std::string>(items).subspan(1));
+
+    REQUIRE(storage.GetSize() == items.size());
+    REQUIRE(&storage.Get(0) == first);
+    for (size_t i = 0; i < items.size(); ++i) {
+        REQUIRE(storage.Get(i) == items[i]);
+    }
+}
+
+TEST_CASE("Concurrent lazy sequence under contention") {
+    const int64_t start[] = {0};
+    auto naturals = std::make_shared<LazySequence<int64_t>>(
+        [](SequencePtr<int64_t> last) {
+            return last->GetFirst() + 1;
+        },
+        std::make_shared<ArraySequence<int64_t>>(start, 1), 1);
+    ConcurrentLazySequence<int64_t> seq(naturals);
+    const int64_t* first = &seq.GetIndex(0);
+
+    const size_t n = 200000;
+    std::atomic<size_t> mismatches = 0;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&seq, &mismatches, t] {
+            // Every thread strides forward at its own pace, so reads and extensions interleave.
+            uint64_t state = t + 1;
+            for (size_t i = 0; i < n; i += 1 + t) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                const size_t back = (state >> 33) % (i + 1);
+                if (seq.GetIndex(i) != static_cast<int64_t>(i) ||
+                    seq.GetIndex(back) != static_cast<int64_t>(back)) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(&seq.GetIndex(0) == first);
+    REQUIRE(seq.GetMaterializedCount() >= n);
+}
+
+TEST_CASE("Concurrent lazy sequence ends with its source") {
+    std::vector<int> data(1000);
+    for (int i = 0; i < 1000; ++i) {
+        data[i] = i * 2;
+    }
+    ConcurrentLazySequence<int> seq(
+        std::make_shared<LazySequence<int>>(std::make_shared<ArraySequence<int>>(data.data(), 1000)));
+
+    std::vector<std::thread> threads;
+    std::atomic<int> found = 0;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            found += seq.HasIndex(999) && !seq.HasIndex(1000);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(found == 4);
+    REQUIRE(seq.GetIndex(999) == 1998);
+    REQUIRE_THROWS_AS(seq.GetIndex(1000), std::out_of_range);
+    REQUIRE(seq.GetLength() == Cardinal(1000));
+}
+
+TEST_CASE("Parallel Reduce, Map and Where match the serial ones") {
+    ThreadPool pool(3);
+    std::vector<int> data(100003);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i * 7919 % 1000);
+    }
+    auto array = std::make_shared<LazySequence<int>>(std::make_shared<ArraySequence<int>>(data.data(), 100003));
+    auto squares = array->Map([](int x) {
+        return int64_t{x} * x;
+    });
+    auto isOdd = [](int64_t x) {
+        return x % 2 == 1;
+    };
+
+    for (size_t grain : {1, 1000, 1 << 20}) {
+        REQUIRE(ParallelReduce(pool, squares, int64_t{0}, std::plus<>{}, grain) ==
+                squares->Reduce(int64_t{0}, std::plus<>{}));
+
+        auto mapped = ParallelMap(
+            pool, array,
+            [](int x) {
+                return int64_t{x} * x;
+            },
+            grain);
+        auto filtered = ParallelWhere(pool, squares, isOdd, grain);
+        auto expected = squares->Where(isOdd);
+        REQUIRE(mapped->GetLength() == Cardinal(data.size()));
+        for (size_t i = 0; i < data.size(); ++i) {
+            REQUIRE(mapped->GetIndex(i) == squares->GetIndex(i));
+        }
+        REQUIRE(filtered->GetLength() == Cardinal(expected->Reduce(size_t{0}, [](size_t n, int64_t) {
+            return n + 1;
+        })));
+        for (size_t i = 0; i < filtered->GetLength().GetFinite(); ++i) {
+            REQUIRE(filtered->GetIndex(i) == expected->GetIndex(i));
+        }
+    }
+
+    REQUIRE(ParallelReduce(pool, std::make_shared<LazySequence<int>>(), 0, std::plus<>{}) == 0);
+    REQUIRE_THROWS_AS(ParallelReduce(pool, squares->Where(isOdd), int64_t{0}, std::plus<>{}), std::logic_error);
+}
+
+TEST_CASE("ArraySequence copies read on other threads") {
+    const int items[] = {1, 2, 3};
+    for (int round = 0; round < 100; ++round) {
+        ArraySequence<int> array(items, 3);
+        std::atomic<int> sum = 0;
+        std::thread reader([&sum, copy = array]() mutable {
+            sum = copy.Get(0) + copy.Get(2);
+        });
+        // Once the reader dropped its copy the buffer is written in place, after the reads.
+        while (array.IsShared()) {
+            std::this_thread::yield();
+        }
+        *array.begin() = 42;
+        reader.join();
+        REQUIRE(sum == 4);
+        REQUIRE(array.Get(0) == 42);
+    }
+}
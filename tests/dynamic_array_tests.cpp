@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "array_sequence.hpp"
+#include "checked.hpp"
+#include "dynamic_array.hpp"
+#include "segmented_sequence.hpp"
+
+TEST_CASE("DynamicArray reserve and growth") {
+    DynamicArray<int> a;
+    a.Reserve(10);
+    REQUIRE(a.GetSize() == 0);
+    REQUIRE(a.GetCapacity() == 10);
+
+    for (int i = 0; i < 1000; ++i) {
+        a.PushBack(i);
+    }
+    REQUIRE(a.GetSize() == 1000);
+    REQUIRE(a.GetCapacity() >= 1000);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(a.Get(i) == i);
+    }
+
+    a.Resize(3);
+    REQUIRE(a.GetSize() == 3);
+    a.Resize(5);
+    REQUIRE(a.Get(4) == 0);
+    REQUIRE_THROWS_AS(a.Get(5), std::out_of_range);
+}
+
+TEST_CASE("DynamicArray with non-trivial elements") {
+    DynamicArray<std::string> a;
+    for (int i = 0; i < 100; ++i) {
+        a.PushBack(std::string(40, static_cast<char>('a' + i % 26)));
+    }
+    a.Insert(0, "first");
+    a.Insert(50, "middle");
+    a.Insert(a.GetSize(), "last");
+    REQUIRE(a.GetSize() == 103);
+    REQUIRE(a.Get(0) == "first");
+    REQUIRE(a.Get(1) == std::string(40, 'a'));
+    REQUIRE(a.Get(50) == "middle");
+    REQUIRE(a.Get(102) == "last");
+
+    // Arguments referring into the array survive the reallocation they trigger.
+    a.Reserve(a.GetSize());
+    a.PushBack(a.Get(0));
+    a.AppendRange(a.GetConstBegin(), 2);
+    REQUIRE(a.Get(103) == "first");
+    REQUIRE(a.Get(105) == std::string(40, 'a'));
+
+    DynamicArray<std::string> copy(a);
+    a = a;
+    a = std::move(a);
+    REQUIRE(a.GetSize() == 106);
+    copy = a;
+    REQUIRE(copy.Get(50) == "middle");
+}
+
+TEST_CASE("ArraySequence on DynamicArray") {
+    ArraySequence<std::string> seq;
+    seq.Append("b");
+    seq.Prepend("a");
+    seq.InsertAt("c", 2);
+    REQUIRE(seq.GetLength() == 3);
+    REQUIRE(seq.Get(0) == "a");
+    REQUIRE(seq.Get(2) == "c");
+    REQUIRE_THROWS_AS(seq.InsertAt("x", 4), std::out_of_range);
+
+    seq.Clear();
+    REQUIRE(seq.GetLength() == 0);
+    REQUIRE(seq.GetCapacity() >= 3);
+}
+
+TEST_CASE("ArraySequence is a contiguous range") {
+    static_assert(std::ranges::contiguous_range<ArraySequence<int>>);
+    static_assert(std::ranges::contiguous_range<const ArraySequence<int>>);
+
+    const int items[] = {5, 3, 4, 1, 2};
+    ArraySequence<int> seq(items, 5);
+    std::ranges::sort(seq);
+    REQUIRE(std::ranges::equal(seq, std::vector<int>{1, 2, 3, 4, 5}));
+
+    int sum = 0;
+    for (int x : std::as_const(seq)) {
+        sum += x;
+    }
+    REQUIRE(sum == 15);
+
+    const ArraySequence<int> copy(static_cast<const Sequence<int>&>(seq));
+    REQUIRE(std::ranges::equal(copy, seq));
+}
+
+TEST_CASE("ArraySequence range insertion") {
+    const std::vector<int> source = {1, 2, 6, 7};
+    ArraySequence<int> ints(source.begin(), source.end());
+    REQUIRE(ints.GetCapacity() == 4);
+    const int middle[] = {3, 4, 5};
+    ints.InsertRange(middle, 2);
+    REQUIRE(std::ranges::equal(ints, std::vector<int>{1, 2, 3, 4, 5, 6, 7}));
+    ints.InsertRange(std::span<const int>(ints.begin(), 2), 7);
+    ints.InsertRange(std::span<const int>(ints.begin() + 5, 4), 0);
+    REQUIRE(std::ranges::equal(ints, std::vector<int>{6, 7, 1, 2, 1, 2, 3, 4, 5, 6, 7, 1, 2}));
+    REQUIRE_THROWS_AS(ints.InsertRange(middle, 14), std::out_of_range);
+
+    ArraySequence<std::string> strings;
+    const char* names[] = {"p", "q"};
+    strings.AppendRange(std::begin(names), std::end(names));
+    strings.AppendRange(std::vector<std::string>{"x", "y"});
+    const std::vector<std::string> words = {"a", "b"};
+    strings.InsertRange(words.begin(), words.end(), 1);
+    strings.InsertRange(std::span<const std::string>(strings.begin(), 3), 5);
+    REQUIRE(std::ranges::equal(strings, std::vector<std::string>{"p", "a", "b", "q", "x", "p", "a", "b", "y"}));
+}
+
+TEST_CASE("ArraySequence subsequences share the buffer until written") {
+    std::vector<std::string> items;
+    for (int i = 0; i < 10; ++i) {
+        items.push_back(std::to_string(i));
+    }
+    auto seq = std::make_shared<ArraySequence<std::string>>(items.begin(), items.end());
+    const std::string* third = &seq->Get(3);
+    auto middle = std::static_pointer_cast<ArraySequence<std::string>>(seq->GetSubsequence(2, 7));
+    REQUIRE(seq->IsShared());
+    REQUIRE(&middle->Get(1) == third);
+    REQUIRE(middle->GetCapacity() == 6);
+
+    // A view narrowed at either end still shares.
+    middle->RemoveRange(0, 0);
+    middle->RemoveRange(4, 4);
+    REQUIRE(&middle->GetFirst() == third);
+    REQUIRE(middle->GetLength() == 4);
+
+    // Appending an item of the shared buffer copies the view first.
+    middle->Append(middle->Get(0));
+    REQUIRE(std::ranges::equal(*middle, std::vector<std::string>{"3", "4", "5", "6", "3"}));
+    REQUIRE_FALSE(seq->IsShared());
+    REQUIRE(&seq->Get(3) == third);
+
+    const ArraySequence<std::string> copy(*seq);
+    seq->InsertAt("x", 0);
+    REQUIRE(copy.GetLength() == 10);
+    REQUIRE(&copy.GetConstBegin()[3] == third);
+    REQUIRE(seq->Get(4) == "3");
+    REQUIRE_FALSE(copy.IsShared());
+}
+
+TEST_CASE("Unchecked element access") {
+    DynamicArray<int> array(4);
+    for (size_t i = 0; i < array.GetSize(); ++i) {
+        array[i] = static_cast<int>(i * 10);
+    }
+    REQUIRE(array.data()[3] == 30);
+
+    ArraySequence<int> seq(array);
+    const auto view = std::static_pointer_cast<ArraySequence<int>>(seq.GetSubsequence(1, 2));
+    REQUIRE((*view)[1] == 20);
+    // Writing through operator[] copies the shared buffer first.
+    seq[2] = 7;
+    REQUIRE(seq.data()[2] == 7);
+    REQUIRE(std::as_const(*view)[1] == 20);
+
+    SegmentedSequence<int> segmented(array.data(), 4);
+    REQUIRE(segmented[3] == 30);
+
+    if constexpr (kChecked) {
+        REQUIRE_THROWS_AS(array[4], std::out_of_range);
+        REQUIRE_THROWS_AS(std::as_const(seq)[4], std::out_of_range);
+        REQUIRE_THROWS_AS(segmented[4], std::out_of_range);
+    }
+}
+
+TEST_CASE("SegmentedSequence keeps items in place") {
+    SegmentedSequence<std::string> seq;
+    const size_t n = 3 * SegmentedSequence<std::string>::kBlockSize + 5;
+    for (size_t i = 0; i < n; ++i) {
+        seq.Append(std::to_string(i));
+    }
+    const std::string* first = &seq.Get(0);
+    const std::string* last = &seq.Get(n - 1);
+    seq.Append(seq.Get(0));
+    seq.Prepend("front");
+
+    REQUIRE(&seq.Get(1) == first);
+    REQUIRE(&seq.Get(n) == last);
+    REQUIRE(seq.GetLength() == n + 2);
+    REQUIRE(seq.GetFirst() == "front");
+    REQUIRE(seq.GetLast() == "0");
+
+    seq.InsertAt("middle", 100);
+    REQUIRE(seq.Get(99) == "98");
+    REQUIRE(seq.Get(100) == "middle");
+    REQUIRE(seq.Get(101) == "99");
+
+    seq.RemoveRange(100, 100);
+    seq.RemoveRange(0, SegmentedSequence<std::string>::kBlockSize);
+    REQUIRE(seq.GetFirst() == std::to_string(SegmentedSequence<std::string>::kBlockSize));
+    REQUIRE(&seq.Get(n - 1 - SegmentedSequence<std::string>::kBlockSize) == last);
+
+    std::vector<std::string> got;
+    for (auto it = seq.GetConstEnumerator(); !it->IsEnd(); it->MoveNext()) {
+        got.push_back(it->ConstDereference());
+    }
+    REQUIRE(got.size() == seq.GetLength());
+    for (size_t i = 0; i < got.size(); ++i) {
+        REQUIRE(got[i] == seq.Get(i));
+    }
+    auto sub = seq.GetSubsequence(10, 200);
+    REQUIRE(sub->GetLength() == 191);
+    REQUIRE(sub->Get(190) == seq.Get(200));
+
+    std::vector<std::string> copied(300);
+    REQUIRE(seq.CopyTo(seq.GetLength() - 200, copied) == 200);
+    REQUIRE(copied[199] == "0");
+}
+
+TEST_CASE("SegmentedSequence reuses blocks of a sliding window") {
+    SegmentedSequence<int> seq;
+    for (int i = 0; i < 100000; ++i) {
+        seq.Append(i);
+        if (seq.GetLength() == 2000) {
+            seq.RemoveRange(0, 999);
+        }
+    }
+    REQUIRE(seq.GetFirst() == 99000);
+    REQUIRE(seq.GetLast() == 99999);
+    REQUIRE(seq.GetCapacity() < 2000 + 2 * SegmentedSequence<int>::kBlockSize);
+
+    seq.Resize(10);
+    REQUIRE(seq.GetLength() == 10);
+    seq.Resize(20);
+    REQUIRE(seq.Get(9) == 99009);
+    REQUIRE(seq.Get(19) == 0);
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "array_sequence.hpp"
+#include "lazy_sequence.hpp"
+#include "pipeline.hpp"
+
+TEST_CASE("Pipeline matches the LazySequence chain") {
+    std::vector<int> data;
+    for (int i = 0; i < 1000; ++i) {
+        data.push_back(i);
+    }
+    auto lazy = std::make_shared<LazySequence<int>>(std::make_shared<ArraySequence<int>>(data.data(), 1000));
+    auto chained = lazy->Map([](int x) {
+                           return int64_t{x} * 3;
+                       })
+                       ->Where([](int64_t x) {
+                           return x % 2 == 0;
+                       });
+    const int64_t expected = chained->Reduce(int64_t{0}, std::plus<>{});
+
+    auto fused = MakePipeline(std::span<const int>(data))
+                     .Map([](int x) {
+                         return int64_t{x} * 3;
+                     })
+                     .Where([](int64_t x) {
+                         return x % 2 == 0;
+                     });
+    REQUIRE(std::move(fused).Reduce(int64_t{0}, std::plus<>{}) == expected);
+
+    auto fromLazy = MakePipeline(lazy).Map([](int x) {
+        return int64_t{x} * 3;
+    });
+    auto res = std::move(fromLazy)
+                   .Where([](int64_t x) {
+                       return x % 2 == 0;
+                   })
+                   .ToArraySequence();
+    REQUIRE(res->GetLength() == 500);
+    REQUIRE(res->Get(1) == 6);
+    REQUIRE(res->GetLast() == 2994);
+}
+
+TEST_CASE("Pipeline Take bounds infinite sources") {
+    auto squares = Iota(1)
+                       .Map([](int x) {
+                           return x * x;
+                       })
+                       .Where([](int x) {
+                           return x % 2 == 1;
+                       })
+                       .Take(4)
+                       .ToArraySequence();
+    REQUIRE(squares->GetLength() == 4);
+    REQUIRE(squares->Get(0) == 1);
+    REQUIRE(squares->Get(3) == 49);
+
+    auto none = Iota(0).Take(0).ToArraySequence();
+    REQUIRE(none->GetLength() == 0);
+}
+
+TEST_CASE("Pipeline Zip ends with the shorter side") {
+    const int items[] = {10, 20, 30};
+    const ArraySequence<int> seq(items, 3);
+    auto zipped = Iota<size_t>(0).Zip(MakePipeline(seq)).ToArraySequence();
+    REQUIRE(zipped->GetLength() == 3);
+    REQUIRE(zipped->Get(2) == std::pair<size_t, int>(2, 30));
+
+    auto pulled = MakePipeline(seq).Zip(Iota(0).Where([](int x) {
+        return x % 5 == 0;
+    }));
+    REQUIRE(pulled.Next() == std::pair<int, int>(10, 0));
+    REQUIRE(pulled.Next() == std::pair<int, int>(20, 5));
+    REQUIRE(pulled.Next() == std::pair<int, int>(30, 10));
+    REQUIRE_FALSE(pulled.Next().has_value());
+}
@@ -0,0 +1,239 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "array_sequence.hpp"
+#include "base64_encode_stream.hpp"
+#include "lazy_sequence.hpp"
+#include "mmap_read_stream.hpp"
+#include "random_byte_stream.hpp"
+#include "read_stream.hpp"
+#include "write_stream.hpp"
+
+namespace {
+
+template <typename T>
+std::vector<T> ReadAll(ReadOnlyStream<T>& stream) {
+    std::vector<T> res;
+    while (!stream.IsEndOfStream()) {
+        res.push_back(stream.Read());
+    }
+    return res;
+}
+
+template <typename T>
+std::vector<T> ReadAllBulk(ReadOnlyStream<T>& stream, size_t chunk) {
+    std::vector<T> res;
+    std::vector<T> buffer(chunk);
+    while (size_t n = stream.Read(std::span<T>(buffer))) {
+        res.insert(res.end(), buffer.begin(), buffer.begin() + n);
+    }
+    return res;
+}
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream is(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+std::string WriteTempFile(const std::vector<uint8_t>& bytes) {
+    const std::string path = "lab1_stream_tests.bin";
+    std::ofstream os(path, std::ios::binary);
+    os.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return path;
+}
+
+}  // namespace
+
+TEST_CASE("Bulk read from SequenceReadStream") {
+    int data[] = {1, 2, 3, 4, 5, 6, 7};
+    SequenceReadStream<int> stream(std::make_shared<ArraySequence<int>>(data, 7));
+
+    int buffer[3];
+    REQUIRE(stream.Read(std::span<int>(buffer)) == 3);
+    REQUIRE(buffer[2] == 3);
+    REQUIRE(stream.Read() == 4);
+    REQUIRE(stream.Read(std::span<int>(buffer)) == 3);
+    REQUIRE(buffer[0] == 5);
+    REQUIRE(stream.GetPosition() == 7);
+    REQUIRE(stream.Read(std::span<int>(buffer)) == 0);
+    REQUIRE(stream.IsEndOfStream());
+}
+
+TEST_CASE("Bulk read from RandomByteStream matches single reads") {
+    RandomByteStream single(10000, 5);
+    RandomByteStream bulk(10000, 5);
+    REQUIRE(ReadAllBulk<uint8_t>(bulk, 333) == ReadAll<uint8_t>(single));
+    REQUIRE(bulk.GetPosition() == 10000);
+}
+
+TEST_CASE("Bulk read from FileReadStream") {
+    std::vector<uint8_t> bytes(5000);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 7);
+    }
+    const std::string path = WriteTempFile(bytes);
+
+    FileReadStream<uint8_t, RawParse<uint8_t>> single(path, RawParse<uint8_t>{});
+    REQUIRE(ReadAll<uint8_t>(single) == bytes);
+
+    FileReadStream<uint8_t, RawParse<uint8_t>> bulk(path, RawParse<uint8_t>{});
+    REQUIRE(ReadAllBulk<uint8_t>(bulk, 4096) == bytes);
+    REQUIRE(bulk.GetPosition() == bytes.size());
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Bulk read from Base64EncodeStream") {
+    RandomByteStream src(10000, 9);
+    const auto plain = ReadAll<uint8_t>(src);
+
+    auto makeEncoder = [&plain](size_t bufferSize) {
+        auto seq = std::make_shared<ArraySequence<uint8_t>>(plain.data(), static_cast<int>(plain.size()));
+        return Base64EncodeStream(std::make_unique<SequenceReadStream<uint8_t>>(std::move(seq)), bufferSize);
+    };
+
+    auto single = makeEncoder(3);
+    const auto expected = ReadAll<char>(single);
+    for (size_t bufferSize : {1, 100, 4096}) {
+        for (size_t chunk : {1, 7, 64, 100000}) {
+            auto bulk = makeEncoder(bufferSize);
+            REQUIRE(ReadAllBulk<char>(bulk, chunk) == expected);
+            REQUIRE(bulk.GetPosition() == expected.size());
+        }
+    }
+
+    Base64EncodeStream empty(std::make_unique<RandomByteStream>(0, 1));
+    char buffer[4];
+    REQUIRE(empty.Read(std::span<char>(buffer)) == 0);
+}
+
+TEST_CASE("TryRead reports the end without throwing") {
+    Base64EncodeStream empty(std::make_unique<SequenceReadStream<uint8_t>>(std::make_shared<ArraySequence<uint8_t>>()));
+    REQUIRE_FALSE(empty.IsEndOfStream());
+    REQUIRE_FALSE(empty.TryRead().has_value());
+    REQUIRE(empty.IsEndOfStream());
+    REQUIRE_THROWS_AS(empty.Read(), std::runtime_error);
+
+    // The length of a filtered sequence is an upper bound, so IsEndOfStream() cannot see the end coming.
+    uint8_t bytes[] = {1, 200, 3, 250, 5};
+    auto big = std::make_shared<LazySequence<uint8_t>>(bytes, 5)->Where([](uint8_t b) {
+        return b > 100;
+    });
+    Base64EncodeStream encoder(std::make_unique<LazySequenceReadStream<uint8_t>>(big));
+    std::string encoded;
+    while (const std::optional<char> c = encoder.TryRead()) {
+        encoded.push_back(*c);
+    }
+    REQUIRE(encoded == "yPo=");
+
+    auto parse = [](const std::string& s) {
+        return std::stoi(s);
+    };
+    StringReadStream<int, decltype(parse)> numbers(" 12 7  30 \n", parse);
+    std::vector<int> parsed;
+    while (const std::optional<int> n = numbers.TryRead()) {
+        parsed.push_back(*n);
+    }
+    REQUIRE(parsed == std::vector<int>({12, 7, 30}));
+}
+
+TEST_CASE("Bulk write to SequenceWriteStream") {
+    auto seq = std::make_shared<ArraySequence<int>>();
+    SequenceWriteStream<int> stream(seq);
+    const int data[] = {1, 2, 3, 4, 5};
+
+    REQUIRE(stream.Write(std::span<const int>(data)) == 5);
+    REQUIRE(stream.Write(6) == 6);
+    REQUIRE(stream.Write(std::span<const int>(data, 2)) == 8);
+    REQUIRE(seq->GetLength() == 8);
+    REQUIRE(seq->Get(4) == 5);
+    REQUIRE(seq->Get(5) == 6);
+    REQUIRE(seq->Get(7) == 2);
+}
+
+TEST_CASE("Buffered FileWriteStream") {
+    std::string expected;
+    for (size_t i = 0; i < 20000; ++i) {
+        expected.push_back(static_cast<char>('a' + i % 26));
+    }
+    const std::string path = "lab1_write_tests.txt";
+    auto serialize = [](std::ostream& os, char c) {
+        os.put(c);
+    };
+
+    for (size_t bufferSize : {1, 100, 4096, 1 << 16}) {
+        {
+            FileWriteStream<char, RawSerialize<char>> raw(path, RawSerialize<char>{}, bufferSize);
+            raw.Write(expected[0]);
+            REQUIRE(raw.Write(std::span<const char>(expected.data() + 1, 9000)) == 9001);
+            for (size_t i = 9001; i < 12000; ++i) {
+                raw.Write(expected[i]);
+            }
+            REQUIRE(raw.Write(std::span<const char>(expected.data() + 12000, 8000)) == expected.size());
+        }
+        REQUIRE(ReadFile(path) == expected);
+
+        {
+            FileWriteStream<char, decltype(serialize)> custom(path, serialize, bufferSize);
+            custom.Write(std::span<const char>(expected.data(), 10000));
+            for (size_t i = 10000; i < expected.size(); ++i) {
+                custom.Write(expected[i]);
+            }
+            custom.Flush();
+            REQUIRE(ReadFile(path) == expected);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("MmapReadStream") {
+    std::vector<uint8_t> bytes(10000);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+    const std::string path = WriteTempFile(bytes);
+
+    {
+        MmapReadStream stream(path);
+        REQUIRE(stream.GetSize() == bytes.size());
+        REQUIRE(stream.IsCanSeek());
+        REQUIRE(stream.IsCanGoBack());
+        REQUIRE(stream.IsCanView());
+        REQUIRE(ReadAll<uint8_t>(stream) == bytes);
+
+        REQUIRE(stream.Seek(100) == 100);
+        REQUIRE(stream.Read() == bytes[100]);
+        const auto view = stream.ReadView(50);
+        REQUIRE(view.size() == 50);
+        REQUIRE(view.data() == stream.GetView().data() + 101);
+        REQUIRE(stream.GetPosition() == 151);
+
+        stream.Seek(bytes.size() - 10);
+        REQUIRE(stream.ReadView(100).size() == 10);
+        REQUIRE(stream.IsEndOfStream());
+        REQUIRE_THROWS_AS(stream.Seek(bytes.size() + 1), std::out_of_range);
+
+        stream.Seek(0);
+        REQUIRE(ReadAllBulk<uint8_t>(stream, 999) == bytes);
+    }
+
+    auto seq = std::make_shared<ArraySequence<uint8_t>>(bytes.data(), static_cast<int>(bytes.size()));
+    Base64EncodeStream expected(std::make_unique<SequenceReadStream<uint8_t>>(std::move(seq)));
+    const auto encoded = ReadAll<char>(expected);
+    for (size_t bufferSize : {1, 2, 3, 100, 4096, 100000}) {
+        Base64EncodeStream encoder(std::make_unique<MmapReadStream>(path), bufferSize);
+        REQUIRE(ReadAllBulk<char>(encoder, 1000) == encoded);
+    }
+    std::remove(path.c_str());
+
+    const std::string emptyPath = WriteTempFile({});
+    MmapReadStream empty(emptyPath);
+    REQUIRE(empty.IsEndOfStream());
+    REQUIRE(empty.ReadView(10).empty());
+    std::remove(emptyPath.c_str());
+}
@@ -1,4 +1,9 @@
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <ranges>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "array_sequence.hpp"
@@ -42,6 +47,124 @@ TEST_CASE("Generator") {
     REQUIRE(fib->GetMaterializedCount() >= 10);
 }
 
+TEST_CASE("Generator window") {
+    auto start = std::make_shared<ArraySequence<int>>();
+    start->Append(1);
+    start->Append(2);
+
+    std::vector<SequencePtr<int>> kept;
+    auto seq = std::make_shared<LazySequence<int>>(
+        [&kept](SequencePtr<int> last2) {
+            REQUIRE_THROWS_AS(last2->Append(0), std::logic_error);
+            if (kept.size() < 3) {
+                kept.push_back(last2);
+            }
+            return last2->GetFirst() + last2->GetLast();
+        },
+        start, 2);
+
+    REQUIRE(seq->GetIndex(40) == 267914296);
+    REQUIRE(seq->GetIndex(4) == 8);
+    // Windows kept by the function stay valid after the memo has grown.
+    REQUIRE(kept.size() == 3);
+    REQUIRE(kept[0]->Get(0) == 1);
+    REQUIRE(kept[0]->Get(1) == 2);
+    REQUIRE(kept[2]->GetSubsequence(0, 1)->Get(1) == 5);
+}
+
+TEST_CASE("Memoization policy") {
+    auto start = std::make_shared<ArraySequence<int64_t>>();
+    start->Append(1);
+    start->Append(1);
+    auto fib = std::make_shared<LazySequence<int64_t>>(
+        [](SequencePtr<int64_t> last2) {
+            return (last2->Get(0) + last2->Get(1)) % 1000003;
+        },
+        start, 2);
+    // A window smaller than the arity still keeps what the generator needs.
+    fib->SetMemoization(Memoization::Window(1));
+
+    MonotonicArena arena;
+    ScopedDefaultResource scope(&arena);
+    auto first = std::make_shared<ArraySequence<int64_t>>();
+    first->Append(0);
+    auto naturals = std::make_shared<LazySequence<int64_t>>(
+        [](SequencePtr<int64_t> last) {
+            return last->GetFirst() + 1;
+        },
+        first, 1);
+    auto windowed = naturals->Map([](int64_t x) {
+        return x * 2;
+    });
+    naturals->SetMemoization(Memoization::None());
+    windowed->SetMemoization(Memoization::Window(16));
+
+    REQUIRE(fib->GetIndex(39) == 102334155 % 1000003);
+    REQUIRE(fib->GetIndex(38) == 63245986 % 1000003);
+    REQUIRE_THROWS_AS(fib->GetIndex(10), std::out_of_range);
+    REQUIRE(fib->GetMaterializedCount() == 40);
+
+    const size_t n = 100000;
+    REQUIRE(windowed->GetIndex(n - 1) == 2 * static_cast<int64_t>(n - 1));
+    REQUIRE(windowed->GetIndex(n - 16) == 2 * static_cast<int64_t>(n - 16));
+    REQUIRE_THROWS_AS(windowed->GetIndex(n - 100), std::out_of_range);
+    REQUIRE_THROWS_AS(naturals->GetIndex(0), std::out_of_range);
+    REQUIRE(windowed->GetMaterializedCount() == n);
+    // Bounded memos stay within a few generator batches, whatever the length of the stream.
+    REQUIRE(arena.GetAllocatedBytes() < 64 * 1024);
+}
+
+TEST_CASE("GetBlock keeps a whole block under a bounded memo") {
+    auto first = std::make_shared<ArraySequence<int64_t>>();
+    first->Append(0);
+    auto naturals = std::make_shared<LazySequence<int64_t>>(
+        [](SequencePtr<int64_t> last) {
+            return last->GetFirst() + 1;
+        },
+        first, 1);
+    naturals->SetMemoization(Memoization::None());
+
+    size_t next = 0;
+    while (next < 10000) {
+        const std::span<const int64_t> block = naturals->GetBlock(next, 4096);
+        REQUIRE(block.size() > 1);
+        for (int64_t x : block) {
+            REQUIRE(x == static_cast<int64_t>(next++));
+        }
+    }
+    REQUIRE_THROWS_AS(naturals->GetIndex(0), std::out_of_range);
+}
+
+TEST_CASE("Batched materialization") {
+    size_t calls = 0;
+    auto first = std::make_shared<ArraySequence<int64_t>>();
+    first->Append(0);
+    auto naturals = std::make_shared<LazySequence<int64_t>>(
+        [&calls](SequencePtr<int64_t> last) {
+            ++calls;
+            return last->GetFirst() + 1;
+        },
+        first, 1);
+    auto tripled = naturals
+                       ->Where([](int64_t x) {
+                           return x % 3 == 0;
+                       })
+                       ->Map([](int64_t x) {
+                           return x / 3;
+                       });
+
+    // Batches never run the generator past what was asked for.
+    REQUIRE(tripled->GetIndex(9) == 9);
+    REQUIRE(calls == 27);
+
+    auto zipped = tripled->GetSubsequence(0, 1999)->Concat(naturals->GetSubsequence(0, 9))->Zip(naturals);
+    REQUIRE(zipped->GetIndex(2005) == std::pair<int64_t, int64_t>(5, 2005));
+    const int64_t sum = zipped->Reduce(int64_t{0}, [](int64_t acc, const std::pair<int64_t, int64_t>& p) {
+        return acc + p.first;
+    });
+    REQUIRE(sum == 1999 * 2000 / 2 + 45);
+}
+
 TEST_CASE("GetSubsequence") {
     auto base = std::make_shared<ArraySequence<int>>();
     for (int i = 0; i < 10; ++i) {
@@ -109,6 +232,29 @@ TEST_CASE("Concat + Map + Reduce") {
     REQUIRE(sum == 15);
 }
 
+TEST_CASE("Concat with an infinite sequence") {
+    int a[] = {1, 2, 3};
+    auto start = std::make_shared<ArraySequence<int>>(a, 1);
+    auto naturals = std::make_shared<LazySequence<int>>(
+        [](SequencePtr<int> last) {
+            return last->GetFirst() + 1;
+        },
+        start, 1);
+
+    auto c = std::make_shared<LazySequence<int>>(a, 3)->Concat(naturals);
+    REQUIRE(c->GetLength().IsN0());
+
+    auto odd = c->Map([](int x) {
+                    return x * 3;
+                })
+                   ->Where([](int x) {
+                       return x % 2 != 0;
+                   });
+    REQUIRE(odd->GetIndex(0) == 3);
+    REQUIRE(odd->GetIndex(1) == 9);
+    REQUIRE(odd->GetIndex(100) == 3 * 197);
+}
+
 TEST_CASE("Where") {
     int data[] = {1, 2, 3, 4, 5, 6};
     auto seq = std::make_shared<LazySequence<int>>(data, 6);
@@ -137,3 +283,148 @@ TEST_CASE("Zip") {
     REQUIRE(zipped->GetIndex(0) == std::pair{1, 10});
     REQUIRE(zipped->GetIndex(1) == std::pair{2, 20});
 }
+
+TEST_CASE("Random access") {
+    auto squares = LazySequence<int64_t>::FromFunction([](size_t i) {
+        return static_cast<int64_t>(i) * static_cast<int64_t>(i);
+    });
+    REQUIRE(squares->IsRandomAccess());
+
+    const size_t far = 1'000'000'000;
+    auto window = squares->GetSubsequence(far, far + 10);
+    REQUIRE(window->IsRandomAccess());
+    REQUIRE(window->GetIndex(5) == static_cast<int64_t>(far + 5) * static_cast<int64_t>(far + 5));
+    REQUIRE_THROWS_AS(window->GetIndex(11), std::out_of_range);
+
+    auto chain = window->Map([](int64_t x) {
+                           return x + 1;
+                       })
+                     ->Skip(0, 1)
+                     ->InsertAt(-1, 5)
+                     ->Concat(squares);
+    REQUIRE(chain->IsRandomAccess());
+    REQUIRE(chain->GetLength() == Cardinals::N0);
+    REQUIRE(chain->GetIndex(far) == static_cast<int64_t>(far - 10) * static_cast<int64_t>(far - 10));
+    REQUIRE(chain->GetIndex(1000) == 990 * 990);
+    REQUIRE(chain->GetIndex(5) == -1);
+    REQUIRE(chain->GetIndex(6) == static_cast<int64_t>(far + 7) * static_cast<int64_t>(far + 7) + 1);
+    REQUIRE(squares->GetMaterializedCount() == 0);
+
+    // Items near the memo are still generated and memoized in order.
+    REQUIRE(window->GetIndex(0) == static_cast<int64_t>(far) * static_cast<int64_t>(far));
+    REQUIRE(window->GetMaterializedCount() == 11);
+
+    auto evens = squares->Where([](int64_t x) {
+        return x % 2 == 0;
+    });
+    REQUIRE_FALSE(evens->IsRandomAccess());
+    REQUIRE_FALSE(evens->Map([](int64_t x) {
+                           return x;
+                       })
+                      ->IsRandomAccess());
+}
+
+TEST_CASE("References to directly computed items stay valid") {
+    auto naturals = LazySequence<long>::FromFunction([](size_t i) {
+        return static_cast<long>(i);
+    });
+    const long& a = naturals->GetIndex(1'000'000);
+    const long& b = naturals->GetIndex(2'000'000);
+    REQUIRE(naturals->GetBlock(5'000'000, 1)[0] == 5'000'000);
+    naturals->GetIndex(3'000'000);
+    REQUIRE(a == 1'000'000);
+    REQUIRE(b == 2'000'000);
+    REQUIRE(std::min(naturals->GetIndex(4'000'000), naturals->GetIndex(6'000'000)) == 4'000'000);
+    REQUIRE(naturals->GetMaterializedCount() == 0);
+}
+
+TEST_CASE("Random access does not bring back evicted items") {
+    auto naturals = LazySequence<long>::FromFunction([](size_t i) {
+        return static_cast<long>(i);
+    });
+    naturals->SetMemoization(Memoization::Window(16));
+    for (size_t i = 0; i < 100000; ++i) {
+        REQUIRE(naturals->GetIndex(i) == static_cast<long>(i));
+    }
+    REQUIRE_THROWS_AS(naturals->GetIndex(0), std::out_of_range);
+    REQUIRE_THROWS_AS(naturals->GetBlock(0, 1), std::out_of_range);
+    // Peek still computes any index.
+    REQUIRE(naturals->Peek(0) == 0);
+    REQUIRE(naturals->GetIndex(1'000'000'000) == 1'000'000'000);
+}
+
+TEST_CASE("Range-for over a lazy sequence") {
+    static_assert(std::ranges::input_range<LazySequence<int>>);
+
+    auto squares = LazySequence<int>::FromFunction([](size_t i) {
+        return static_cast<int>(i * i);
+    });
+    std::vector<int> seen;
+    for (int x : *squares) {
+        if (x > 100) {
+            break;
+        }
+        seen.push_back(x);
+    }
+    REQUIRE(seen.size() == 11);
+    REQUIRE(seen.back() == 100);
+
+    const int items[] = {1, 2, 3, 4, 5, 6, 7};
+    auto odd = std::make_shared<LazySequence<int>>(std::make_shared<ArraySequence<int>>(items, 7))->Where([](int x) {
+        return x % 2 != 0;
+    });
+    REQUIRE(std::ranges::equal(*odd, std::vector<int>{1, 3, 5, 7}));
+    REQUIRE(std::ranges::distance(odd->begin(), odd->end()) == 4);
+}
+
+TEST_CASE("GetIndex references survive materialization") {
+    auto first = std::make_shared<ArraySequence<int64_t>>();
+    first->Append(0);
+    auto naturals = std::make_shared<LazySequence<int64_t>>(
+        [](SequencePtr<int64_t> last) {
+            return last->GetFirst() + 1;
+        },
+        first, 1);
+    const int64_t& item = naturals->GetIndex(10);
+    naturals->GetIndex(1000000);
+    REQUIRE(&naturals->GetIndex(10) == &item);
+    REQUIRE(item == 10);
+}
+
+TEST_CASE("Pipeline statistics") {
+    auto first = std::make_shared<ArraySequence<int64_t>>();
+    first->Append(0);
+    auto naturals = std::make_shared<LazySequence<int64_t>>(
+        [](SequencePtr<int64_t> last) {
+            return last->GetFirst() + 1;
+        },
+        first, 1);
+    auto odd = naturals->Where([](int64_t x) {
+        return x % 2 == 1;
+    });
+    auto seq = odd->Map([](int64_t x) {
+                      return x * 10;
+                  })
+                   ->Concat(std::make_shared<LazySequence<int64_t>>(first));
+    REQUIRE(seq->GetIndex(99) == 1990);
+
+    const LazySequenceStats stats = odd->GetStats();
+    REQUIRE(stats.materialized >= 100);
+    REQUIRE(stats.memoized == stats.materialized);
+    REQUIRE(stats.memoBytes >= stats.memoized * sizeof(int64_t));
+    if constexpr (kLazySequenceStats) {
+        REQUIRE(stats.generatorCalls > 0);
+        REQUIRE(naturals->GetStats().generatorTime <= seq->GetStats().generatorTime);
+    } else {
+        REQUIRE(stats.generatorCalls == 0);
+    }
+
+    std::ostringstream os;
+    seq->DumpStats(os);
+    const std::string dump = os.str();
+    REQUIRE(dump.starts_with("Concat: "));
+    REQUIRE(dump.find("\n  Map: ") != std::string::npos);
+    REQUIRE(dump.find("\n    Where: ") != std::string::npos);
+    REQUIRE(dump.find("\n      Function: ") != std::string::npos);
+    REQUIRE(dump.find("\n  Array: 1 materialized") != std::string::npos);
+}